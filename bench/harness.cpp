@@ -0,0 +1,411 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  harness.cpp
+ *
+ *    Description:  Minimal Google-Benchmark-style harness for the native benchmarks
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 09:12:40
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "harness.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#ifndef ESTIPOP_VERSION
+#define ESTIPOP_VERSION "unknown"
+#endif
+
+State::State(std::vector<long int> a, long int n) : args(a), iterations(n), done(0), started(false), paused(false),
+	cpuStart(0), real(0), cpu(0) {}
+
+void State::start(){
+	realStart = std::chrono::steady_clock::now();
+	cpuStart = std::clock();
+}
+
+void State::stop(){
+	real += std::chrono::duration<double>(std::chrono::steady_clock::now() - realStart).count();
+	cpu += double(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+}
+
+bool State::keepRunning(){
+	if(!started){
+		started = true;
+		start();
+	}
+	if(done < iterations){
+		done++;
+		return true;
+	}
+	if(!paused)
+		stop();
+	return false;
+}
+
+void State::pause(){
+	if(!paused){
+		stop();
+		paused = true;
+	}
+}
+
+void State::resume(){
+	if(paused){
+		start();
+		paused = false;
+	}
+}
+
+Benchmark::Benchmark(std::string n, std::function<void(State&)> f) : name(n), fn(f) {}
+
+Benchmark* Benchmark::arg(long int x){
+	argSets.push_back(std::vector<long int>(1, x));
+	return this;
+}
+
+Benchmark* Benchmark::args(std::vector<long int> x){
+	argSets.push_back(x);
+	return this;
+}
+
+Benchmark* Benchmark::range(long int lo, long int hi, long int mult){
+	for(long int x = lo; x < hi; x *= mult)
+		arg(x);
+	return arg(hi);
+}
+
+Benchmark* Benchmark::argName(std::string n){
+	argNames = std::vector<std::string>(1, n);
+	return this;
+}
+
+Benchmark* Benchmark::argNamesAre(std::vector<std::string> n){
+	argNames = n;
+	return this;
+}
+
+std::string Benchmark::runName(const std::vector<long int>& a) const{
+	std::ostringstream s;
+	s << name;
+	for(size_t i = 0; i < a.size(); i++){
+		s << "/";
+		if(i < argNames.size() && !argNames[i].empty())
+			s << argNames[i] << ":";
+		s << a[i];
+	}
+	return s.str();
+}
+
+static std::vector<Benchmark*>& registry(){
+	static std::vector<Benchmark*> r;
+	return r;
+}
+
+Benchmark* registerBenchmark(std::string name, std::function<void(State&)> fn){
+	registry().push_back(new Benchmark(name, fn));
+	return registry().back();
+}
+
+// One row of output. Times are nanoseconds per iteration.
+struct Result {
+	std::string name;
+	std::string runName;
+	std::string aggregate; // empty for an iteration run, else mean, median or stddev
+	int repetitions;
+	int repetitionIndex;
+	long int iterations;
+	double real;
+	double cpu;
+	std::map<std::string, double> counters;
+	std::map<std::string, Counter::Kind> kinds;
+	std::string label;
+};
+
+static Result measure(const Benchmark& b, const std::vector<long int>& a, long int n){
+	State s(a, n);
+	b.fn(s);
+	Result r;
+	r.name = r.runName = b.runName(a);
+	r.repetitions = 1;
+	r.repetitionIndex = 0;
+	r.iterations = n;
+	r.real = s.realTime() * 1e9 / n;
+	r.cpu = s.cpuTime() * 1e9 / n;
+	r.label = s.label;
+	for(std::map<std::string, Counter>::const_iterator c = s.counters.begin(); c != s.counters.end(); ++c){
+		double v = c->second.value;
+		if(c->second.kind == Counter::Rate)
+			v = s.realTime() > 0 ? v / s.realTime() : 0;
+		else if(c->second.kind == Counter::Average)
+			v /= n;
+		r.counters[c->first] = v;
+		r.kinds[c->first] = c->second.kind;
+	}
+	return r;
+}
+
+// Mean, median and standard deviation of the repetitions of one run
+static std::vector<Result> aggregates(const std::vector<Result>& runs){
+	std::vector<Result> out;
+	const char* names[] = {"mean", "median", "stddev"};
+	for(int k = 0; k < 3; k++){
+		Result r = runs[0];
+		r.aggregate = names[k];
+		r.name = r.runName + "_" + r.aggregate;
+		r.repetitionIndex = 0;
+		std::function<double(std::vector<double>)> f;
+		if(k == 0)
+			f = [](std::vector<double> v){ double s = 0; for(double x : v) s += x; return s / v.size(); };
+		else if(k == 1)
+			f = [](std::vector<double> v){ std::sort(v.begin(), v.end()); size_t m = v.size() / 2;
+			                               return v.size() % 2 ? v[m] : (v[m - 1] + v[m]) / 2; };
+		else
+			f = [](std::vector<double> v){ double s = 0, q = 0; for(double x : v){ s += x; q += x * x; }
+			                               double m = s / v.size(); return v.size() > 1 ? std::sqrt(std::max(0.0, (q - v.size() * m * m) / (v.size() - 1))) : 0; };
+		std::vector<double> real, cpu;
+		for(const Result& x : runs){
+			real.push_back(x.real);
+			cpu.push_back(x.cpu);
+		}
+		r.real = f(real);
+		r.cpu = f(cpu);
+		for(std::map<std::string, double>::iterator c = r.counters.begin(); c != r.counters.end(); ++c){
+			std::vector<double> v;
+			for(const Result& x : runs)
+				v.push_back(x.counters.at(c->first));
+			c->second = f(v);
+		}
+		out.push_back(r);
+	}
+	return out;
+}
+
+static std::string human(double v){
+	const char* suffix[] = {"", "k", "M", "G", "T"};
+	int i = 0;
+	while(std::fabs(v) >= 1000 && i < 4){
+		v /= 1000;
+		i++;
+	}
+	char buf[32];
+	std::snprintf(buf, sizeof(buf), "%.4g%s", v, suffix[i]);
+	return buf;
+}
+
+static std::string quote(const std::string& s){
+	std::string out = "\"";
+	for(char c : s){
+		if(c == '"' || c == '\\')
+			out += '\\';
+		out += c;
+	}
+	return out + "\"";
+}
+
+static void writeConsole(std::ostream& out, const Result& r){
+	char buf[256];
+	std::snprintf(buf, sizeof(buf), "%-52s %13.0f ns %13.0f ns %10ld", r.name.c_str(), r.real, r.cpu, r.iterations);
+	out << buf;
+	for(std::map<std::string, double>::const_iterator c = r.counters.begin(); c != r.counters.end(); ++c)
+		out << " " << c->first << "=" << human(c->second) << (r.kinds.at(c->first) == Counter::Rate ? "/s" : "");
+	if(!r.label.empty())
+		out << " " << r.label;
+	out << std::endl;
+}
+
+static void writeJson(std::ostream& out, const std::vector<Result>& results, const std::string& executable){
+	char date[64];
+	std::time_t now = std::time(nullptr);
+	std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+	#ifdef NDEBUG
+	const char* build = "release";
+	#else
+	const char* build = "debug";
+	#endif
+
+	out.precision(17);
+	out << "{\n  \"context\": {\n"
+	    << "    \"date\": " << quote(date) << ",\n"
+	    << "    \"executable\": " << quote(executable) << ",\n"
+	    << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+	    << "    \"library_build_type\": " << quote(build) << ",\n"
+	    << "    \"estipop_version\": " << quote(ESTIPOP_VERSION) << "\n"
+	    << "  },\n  \"benchmarks\": [";
+	for(size_t i = 0; i < results.size(); i++){
+		const Result& r = results[i];
+		out << (i ? "," : "") << "\n    {\n"
+		    << "      \"name\": " << quote(r.name) << ",\n"
+		    << "      \"run_name\": " << quote(r.runName) << ",\n"
+		    << "      \"run_type\": " << quote(r.aggregate.empty() ? "iteration" : "aggregate") << ",\n";
+		if(!r.aggregate.empty())
+			out << "      \"aggregate_name\": " << quote(r.aggregate) << ",\n";
+		out << "      \"repetitions\": " << r.repetitions << ",\n"
+		    << "      \"repetition_index\": " << r.repetitionIndex << ",\n"
+		    << "      \"threads\": 1,\n"
+		    << "      \"iterations\": " << r.iterations << ",\n"
+		    << "      \"real_time\": " << r.real << ",\n"
+		    << "      \"cpu_time\": " << r.cpu << ",\n"
+		    << "      \"time_unit\": \"ns\"";
+		for(std::map<std::string, double>::const_iterator c = r.counters.begin(); c != r.counters.end(); ++c)
+			out << ",\n      " << quote(c->first) << ": " << c->second;
+		if(!r.label.empty())
+			out << ",\n      \"label\": " << quote(r.label);
+		out << "\n    }";
+	}
+	out << "\n  ]\n}" << std::endl;
+}
+
+static void writeCsv(std::ostream& out, const std::vector<Result>& results){
+	std::set<std::string> names;
+	for(const Result& r : results)
+		for(std::map<std::string, double>::const_iterator c = r.counters.begin(); c != r.counters.end(); ++c)
+			names.insert(c->first);
+
+	out.precision(17);
+	out << "name,iterations,real_time,cpu_time,time_unit,label";
+	for(const std::string& n : names)
+		out << "," << n;
+	out << "\n";
+	for(const Result& r : results){
+		out << quote(r.name) << "," << r.iterations << "," << r.real << "," << r.cpu << ",ns," << quote(r.label);
+		for(const std::string& n : names){
+			out << ",";
+			if(r.counters.count(n))
+				out << r.counters.at(n);
+		}
+		out << "\n";
+	}
+}
+
+static void usage(){
+	std::cerr << "usage: estipop-bench [options]\n"
+	          << "  --benchmark_filter=REGEX        run only benchmarks whose name matches\n"
+	          << "  --benchmark_min_time=SEC        minimum time per run (default 0.5)\n"
+	          << "  --benchmark_repetitions=N       repeat each run and report mean, median and stddev\n"
+	          << "  --benchmark_format=FORMAT       console, json or csv on standard output\n"
+	          << "  --benchmark_out=FILE            also write the results to FILE\n"
+	          << "  --benchmark_out_format=FORMAT   json (default) or csv\n"
+	          << "  --benchmark_list_tests          list the runs without timing them\n"
+	          << "Results of two releases are compared with Google Benchmark's tools/compare.py on the json output."
+	          << std::endl;
+}
+
+int main(int argc, char** argv){
+	std::string filter = ".", format = "console", outFile, outFormat = "json";
+	double minTime = 0.5;
+	int repetitions = 1;
+	bool list = false;
+
+	for(int i = 1; i < argc; i++){
+		std::string a = argv[i];
+		size_t eq = a.find('=');
+		std::string key = a.substr(0, eq), value = eq == std::string::npos ? "" : a.substr(eq + 1);
+		if(key == "--benchmark_filter") filter = value;
+		else if(key == "--benchmark_min_time") minTime = std::stod(value);
+		else if(key == "--benchmark_repetitions") repetitions = std::stoi(value);
+		else if(key == "--benchmark_format") format = value;
+		else if(key == "--benchmark_out") outFile = value;
+		else if(key == "--benchmark_out_format") outFormat = value;
+		else if(key == "--benchmark_list_tests") list = true;
+		else { usage(); return key == "-h" || key == "--help" ? 0 : 2; }
+	}
+	if(minTime <= 0 || repetitions < 1 || (format != "console" && format != "json" && format != "csv") ||
+	   (outFormat != "json" && outFormat != "csv")){
+		usage();
+		return 2;
+	}
+
+	std::regex pattern(filter);
+	std::vector<Result> results;
+	if(format == "console" && !list){
+		char buf[256];
+		std::snprintf(buf, sizeof(buf), "%-52s %16s %16s %10s", "Benchmark", "Time", "CPU", "Iterations");
+		std::cout << buf << "\n" << std::string(97, '-') << std::endl;
+	}
+
+	try{
+		for(Benchmark* b : registry()){
+			std::vector<std::vector<long int> > sets = b->argSets;
+			if(sets.empty())
+				sets.push_back(std::vector<long int>());
+			for(const std::vector<long int>& a : sets){
+				std::string name = b->runName(a);
+				if(!std::regex_search(name, pattern))
+					continue;
+				if(list){
+					std::cout << name << std::endl;
+					continue;
+				}
+
+				// Grow the iteration count until one run lasts minTime, as Google Benchmark does
+				long int n = 1;
+				Result r;
+				while(true){
+					r = measure(*b, a, n);
+					double seconds = r.real * n / 1e9;
+					if(seconds >= minTime || n >= 1000000000L)
+						break;
+					double mult = seconds > 0 ? std::min(10.0, std::max(1.2, 1.4 * minTime / seconds)) : 10.0;
+					n = std::min(1000000000L, (long int)std::ceil(n * mult));
+				}
+
+				std::vector<Result> runs(1, r);
+				for(int k = 1; k < repetitions; k++){
+					runs.push_back(measure(*b, a, n));
+					runs.back().repetitionIndex = k;
+				}
+				for(Result& x : runs)
+					x.repetitions = repetitions;
+				if(repetitions > 1){
+					std::vector<Result> agg = aggregates(runs);
+					runs.insert(runs.end(), agg.begin(), agg.end());
+				}
+				for(const Result& x : runs){
+					if(format == "console")
+						writeConsole(std::cout, x);
+					results.push_back(x);
+				}
+			}
+		}
+	}
+	catch(std::exception& e){
+		std::cerr << "estipop-bench: " << e.what() << std::endl;
+		return 1;
+	}
+	if(list)
+		return 0;
+
+	if(format == "json")
+		writeJson(std::cout, results, argv[0]);
+	else if(format == "csv")
+		writeCsv(std::cout, results);
+	if(!outFile.empty()){
+		std::ofstream out(outFile);
+		if(!out.is_open()){
+			std::cerr << "estipop-bench: unable to open " << outFile << std::endl;
+			return 1;
+		}
+		if(outFormat == "json")
+			writeJson(out, results, argv[0]);
+		else
+			writeCsv(out, results);
+	}
+	return 0;
+}
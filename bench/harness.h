@@ -0,0 +1,114 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  harness.h
+ *
+ *    Description:  Minimal Google-Benchmark-style harness for the native benchmarks
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 09:12:40
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+#include <map>
+#include <functional>
+#include <chrono>
+#include <ctime>
+
+// A benchmark function runs its timed loop as
+//   while(state.keepRunning()){ ... }
+// with untimed setup between pause() and resume(). The harness picks the iteration count so that a run lasts at least
+// --benchmark_min_time seconds. Command-line flags and the JSON output follow Google Benchmark, so its compare.py
+// works on the results of two releases.
+struct Counter {
+	enum Kind { Plain, Rate, Average }; // as set, per second of real time, per iteration
+
+	double value;
+	Kind kind;
+
+	Counter(double v = 0, Kind k = Plain) : value(v), kind(k) {}
+};
+
+class State {
+public:
+	// Members
+	std::vector<long int> args;
+	std::map<std::string, Counter> counters;
+	std::string label;
+	long int iterations;
+
+	// Constructors
+	State(std::vector<long int> a, long int n);
+
+	// Methods
+	long int range(size_t i = 0) const { return args[i]; }
+	bool keepRunning();
+	void pause();
+	void resume();
+
+	// Elapsed real and CPU seconds, excluding paused time
+	double realTime() const { return real; }
+	double cpuTime() const { return cpu; }
+
+private:
+	long int done;
+	bool started, paused;
+	std::chrono::steady_clock::time_point realStart;
+	std::clock_t cpuStart;
+	double real, cpu;
+
+	void start();
+	void stop();
+};
+
+class Benchmark {
+public:
+	// Members
+	std::string name;
+	std::function<void(State&)> fn;
+	std::vector<std::string> argNames;
+	std::vector<std::vector<long int> > argSets;
+
+	// Constructors
+	Benchmark(std::string n, std::function<void(State&)> f);
+
+	// Methods
+	Benchmark* arg(long int x);
+	Benchmark* args(std::vector<long int> x);
+
+	// lo, lo*mult, lo*mult^2, ... and hi
+	Benchmark* range(long int lo, long int hi, long int mult = 8);
+	Benchmark* argName(std::string n);
+	Benchmark* argNamesAre(std::vector<std::string> n);
+
+	// Name of one run, e.g. BM_BirthDeath/pop:1000
+	std::string runName(const std::vector<long int>& a) const;
+};
+
+Benchmark* registerBenchmark(std::string name, std::function<void(State&)> fn);
+
+// Keep the compiler from discarding a result computed only to be timed
+template <typename T>
+inline void doNotOptimize(const T& value){
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile const T* sink;
+	sink = &value;
+#endif
+}
+
+#define BENCHMARK_CAT(a, b) a##b
+#define BENCHMARK_NAME(a, b) BENCHMARK_CAT(a, b)
+#define BENCHMARK(fn) static Benchmark* BENCHMARK_NAME(benchmark_, __LINE__) = registerBenchmark(#fn, fn)
@@ -0,0 +1,64 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  likelihood.cpp
+ *
+ *    Description:  Benchmarks of the Gaussian likelihood reduction behind bp_loglik
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 09:12:40
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "harness.h"
+
+#include "Likelihood.h"
+
+#include <cmath>
+
+// Moment table with one interval [0, 1]: mean matrix M = exp(.3) I + .05 off the diagonal and one-ancestor covariance
+// (k + 1) I for a type k ancestor, stored as the second moments D = V + M M the way moments() returns them
+static std::vector<double> momentRow(int n){
+	std::vector<double> row(2 + n*n + n*n*n, 0.0);
+	row[0] = 1;
+	row[1] = 1;
+	double* m = &row[2];
+	double* d = m + n*n;
+	for(int k = 0; k < n; ++k)
+		for(int i = 0; i < n; ++i)
+			m[k + n*i] = k == i ? std::exp(.3) : .05;
+	for(int k = 0; k < n; ++k)
+		for(int j = 0; j < n; ++j)
+			for(int i = 0; i < n; ++i)
+				d[k + n*(i + n*j)] = (i == j ? k + 1 : 0) + m[k + n*i] * m[k + n*j];
+	return row;
+}
+
+// Log-likelihood of obs transitions between observations 0 and 1, every one from a different initial population, so
+// that each needs its own Cholesky factorization
+static void BM_GaussianLoglik(State& state){
+	int nobs = state.range(0), n = state.range(1);
+	std::vector<double> row = momentRow(n);
+	MomentTable table(row.data(), 1, row.size(), n);
+
+	std::vector<double> init((size_t)nobs * n), final((size_t)nobs * n), start(nobs, 0.0), end(nobs, 1.0);
+	for(int o = 0; o < nobs; ++o){
+		for(int i = 0; i < n; ++i){
+			init[o + (size_t)nobs*i] = 100 + (o * 7 + i * 13) % 50;
+			final[o + (size_t)nobs*i] = 130 + (o * 11 + i * 5) % 40;
+		}
+	}
+
+	while(state.keepRunning())
+		doNotOptimize(gaussianLoglik(table, init, start, end, final, nobs));
+	state.counters["observations"] = Counter((double)nobs * state.iterations, Counter::Rate);
+}
+BENCHMARK(BM_GaussianLoglik)->argNamesAre({"obs", "types"})
+	->args({10, 1})->args({100, 1})->args({1000, 1})->args({10000, 1})
+	->args({1000, 2})->args({1000, 4})->args({1000, 8});
@@ -0,0 +1,277 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  simulation.cpp
+ *
+ *    Description:  Benchmarks of the simulation hot paths on the README models
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 09:12:40
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "harness.h"
+
+#include "System.h"
+#include "ConstantRate.h"
+#include "Update.h"
+#include "helpers.h"
+
+#include <cstdio>
+#include <sstream>
+#include <gsl/gsl_rng.h>
+
+// Globals the core expects from its host, defined in Controller.cpp for the R package
+gsl_rng* rng = gsl_rng_alloc(gsl_rng_mt19937);
+bool silent = true;
+
+// Expected number of events up to horizon, from the mean equations dm/dt = m A(t) integrated by RK4. Reported as the
+// events counter so that event rates compare across releases without instrumenting the simulator.
+static double expectedEvents(System& sys, double horizon, bool timedep){
+	size_t n = sys.state.size(), nt = sys.from.size();
+	std::vector<std::vector<int> > offspring(nt);
+	for(size_t j = 0; j < nt; j++)
+		offspring[j] = sys.updates[j].get();
+
+	auto rate = [&](size_t j, double t){ return timedep ? (*sys.rates2[j])(t) : sys.rates[j]; };
+	// Derivative of the mean and of the expected event count
+	auto deriv = [&](double t, const std::vector<double>& m, std::vector<double>& dm){
+		std::fill(dm.begin(), dm.end(), 0.0);
+		for(size_t j = 0; j < nt; j++){
+			double flux = rate(j, t) * m[sys.from[j]];
+			for(size_t i = 0; i < n; i++)
+				dm[i] += flux * (offspring[j][i] - (int(i) == sys.from[j]));
+			dm[n] += flux;
+		}
+	};
+
+	std::vector<double> m(n + 1, 0.0), k1(n + 1), k2(n + 1), k3(n + 1), k4(n + 1), tmp(n + 1);
+	for(size_t i = 0; i < n; i++)
+		m[i] = sys.state[i];
+	int steps = 4000;
+	double h = horizon / steps;
+	for(int s = 0; s < steps; s++){
+		double t = s * h;
+		deriv(t, m, k1);
+		for(size_t i = 0; i <= n; i++) tmp[i] = m[i] + h / 2 * k1[i];
+		deriv(t + h / 2, tmp, k2);
+		for(size_t i = 0; i <= n; i++) tmp[i] = m[i] + h / 2 * k2[i];
+		deriv(t + h / 2, tmp, k3);
+		for(size_t i = 0; i <= n; i++) tmp[i] = m[i] + h * k3[i];
+		deriv(t + h, tmp, k4);
+		for(size_t i = 0; i <= n; i++) m[i] += h / 6 * (k1[i] + 2 * k2[i] + 2 * k3[i] + k4[i]);
+	}
+	return m[n];
+}
+
+// Fraction of thinning proposals accepted for a fixed population: the integral of the thinned rates over that of
+// their majorant tables. Requires splitClocks to have been called.
+static double thinningAcceptance(System& sys, double horizon){
+	double exact = 0, bound = 0;
+	int sub = 64;
+	double w = horizon / sys.nbins;
+	for(size_t k = 0; k < sys.thinIndex.size(); k++){
+		Rate& r = *sys.rates2[sys.thinIndex[k]];
+		for(int b = 0; b < sys.nbins; b++){
+			bound += sys.homog_rates[k][b] * w;
+			for(int s = 0; s < sub; s++)
+				exact += r((b + (s + .5) / sub) * w) * w / sub;
+		}
+	}
+	return bound > 0 ? exact / bound : 1;
+}
+
+// Simulate one replicate per iteration into an in-memory sink, reporting replicates and events per second
+static void runReplicates(State& state, System& sys, const std::vector<long int>& init, const std::vector<double>& times,
+                          bool timedep){
+	gsl_rng_set(sys.gen, 1);
+	std::ostringstream sink;
+	sys.sink = &sink;
+#ifndef ESTIPOP_STATS
+	double events = expectedEvents(sys, times.back(), timedep);
+#endif
+	while(state.keepRunning()){
+		sink.str("");
+		sys.reset(init);
+		if(timedep)
+			sys.simulate_timedep(times, "");
+		else
+			sys.simulate(times, "");
+	}
+	state.counters["replicates"] = Counter(state.iterations, Counter::Rate);
+#ifdef ESTIPOP_STATS
+	// Counted rather than expected when the core keeps counters, and the observed acceptance replaces the estimate
+	long int fired = 0;
+	for(size_t i = 0; i < sys.stats.events.size(); i++)
+		fired += sys.stats.events[i];
+	state.counters["events"] = Counter(fired, Counter::Rate);
+	if(sys.stats.proposals > 0)
+		state.counters["acceptance"] = Counter((double)sys.stats.accepts / sys.stats.proposals);
+#else
+	state.counters["events"] = Counter(events * state.iterations, Counter::Rate);
+#endif
+}
+
+// Linear birth-death from the README: birth 1, death 0.7
+static void BM_BirthDeath(State& state){
+	std::vector<long int> init(1, state.range(0));
+	System sys(init);
+	sys.addUpdate(1.0, 0, Update(std::vector<int>(1, 2)));
+	sys.addUpdate(0.7, 0, Update(std::vector<int>(1, 0)));
+	runReplicates(state, sys, init, std::vector<double>{.5, 1}, false);
+}
+BENCHMARK(BM_BirthDeath)->range(10, 10000, 10)->argName("pop");
+
+// Two-mutation drug resistance model from the README, four types sharing a death rate
+static void BM_Resistance(State& state){
+	std::vector<long int> init{state.range(0), 0, 0, 0};
+	System sys(init);
+	double birth[] = {.4, .7, .5, .2};
+	for(int k = 0; k < 4; k++){
+		std::vector<int> o(4, 0);
+		o[k] = 2;
+		sys.addUpdate(birth[k], k, Update(o));
+	}
+	sys.addUpdate(.3, 0, Update(std::vector<int>{1, 1, 0, 0}));
+	sys.addUpdate(.1, 0, Update(std::vector<int>{1, 0, 1, 0}));
+	sys.addUpdate(.4, 1, Update(std::vector<int>{0, 1, 0, 1}));
+	sys.addUpdate(.3, 2, Update(std::vector<int>{0, 0, 1, 1}));
+	for(int k = 0; k < 4; k++)
+		sys.addUpdate(.3, k, Update(std::vector<int>(4, 0)));
+	runReplicates(state, sys, init, std::vector<double>{.5, 1}, false);
+}
+BENCHMARK(BM_Resistance)->range(10, 10000, 10)->argName("pop");
+
+// Time-dependent switch: birth drops from 1 to 0.3 at t = 0.5 under a constant death rate of 0.5, simulated by thinning
+static void BM_Switch(State& state){
+	std::vector<long int> init(1, state.range(0));
+	System sys(init);
+	sys.addUpdate(new SwitchRate(1.0, 0.3, 0.5), 0, Update(std::vector<int>(1, 2)));
+	sys.addUpdate(new ConstantRate(0.5), 0, Update(std::vector<int>(1, 0)));
+	sys.splitClocks(1);
+	state.counters["acceptance"] = Counter(thinningAcceptance(sys, 1));
+	runReplicates(state, sys, init, std::vector<double>{.5, 1}, true);
+}
+BENCHMARK(BM_Switch)->range(10, 10000, 10)->argName("pop");
+
+// Thinning against majorant tables of increasing resolution, for a periodic birth rate
+static void BM_Thinning(State& state){
+	std::vector<long int> init(1, 1000);
+	System sys(init);
+	sys.nbins = state.range(0);
+	sys.addUpdate(new PulseRate(1, .5, .2, 1.0), 0, Update(std::vector<int>(1, 2)));
+	sys.addUpdate(new ConstantRate(.5), 0, Update(std::vector<int>(1, 0)));
+	sys.splitClocks(4);
+	state.counters["acceptance"] = Counter(thinningAcceptance(sys, 4));
+	runReplicates(state, sys, init, std::vector<double>{1, 2, 3, 4}, true);
+}
+BENCHMARK(BM_Thinning)->range(10, 10000, 10)->argName("bins");
+
+// One type with its birth rate split over more and more transitions, so choose dominates each event
+static void BM_Transitions(State& state){
+	std::vector<long int> init(1, 1000);
+	System sys(init);
+	int births = state.range(0) - 1;
+	for(int j = 0; j < births; j++)
+		sys.addUpdate(1.0 / births, 0, Update(std::vector<int>(1, 2)));
+	sys.addUpdate(0.7, 0, Update(std::vector<int>(1, 0)));
+	runReplicates(state, sys, init, std::vector<double>{.5, 1}, false);
+}
+BENCHMARK(BM_Transitions)->range(2, 256, 4)->argName("transitions");
+
+// A chain of types, each giving birth, dying and mutating into the next, so the state and update vectors grow
+static void BM_Types(State& state){
+	int n = state.range(0);
+	std::vector<long int> init(n, 0);
+	init[0] = 1000;
+	System sys(init);
+	for(int k = 0; k < n; k++){
+		std::vector<int> birth(n, 0), death(n, 0), mutation(n, 0);
+		birth[k] = 2;
+		sys.addUpdate(.5, k, Update(birth));
+		sys.addUpdate(.4, k, Update(death));
+		if(k + 1 < n){
+			mutation[k] = 1;
+			mutation[k + 1] = 1;
+			sys.addUpdate(.1, k, Update(mutation));
+		}
+	}
+	runReplicates(state, sys, init, std::vector<double>{.5, 1}, false);
+}
+BENCHMARK(BM_Types)->range(1, 64, 4)->argName("types");
+
+// Many short replicates, written the way branch() writes them: one append to the output file per row
+static void BM_ReplicatesFile(State& state){
+	std::vector<long int> init(1, 10);
+	System sys(init);
+	sys.addUpdate(1.0, 0, Update(std::vector<int>(1, 2)));
+	sys.addUpdate(0.7, 0, Update(std::vector<int>(1, 0)));
+	std::vector<double> times{1, 2, 3, 4, 5};
+	std::string file = "estipop-bench-replicates.csv";
+	gsl_rng_set(sys.gen, 1);
+	long int reps = state.range(0);
+	while(state.keepRunning()){
+		state.pause();
+		std::remove(file.c_str());
+		state.resume();
+		for(long int r = 0; r < reps; r++){
+			sys.reset(init);
+			sys.simulate(times, file);
+			sys.nextRep();
+		}
+	}
+	std::remove(file.c_str());
+	state.counters["replicates"] = Counter(reps * state.iterations, Counter::Rate);
+}
+BENCHMARK(BM_ReplicatesFile)->range(1, 1000, 10)->argName("reps");
+
+// The same replicates written to an in-memory sink, as estipop-sim does
+static void BM_ReplicatesSink(State& state){
+	std::vector<long int> init(1, 10);
+	System sys(init);
+	sys.addUpdate(1.0, 0, Update(std::vector<int>(1, 2)));
+	sys.addUpdate(0.7, 0, Update(std::vector<int>(1, 0)));
+	std::vector<double> times{1, 2, 3, 4, 5};
+	std::ostringstream sink;
+	sys.sink = &sink;
+	gsl_rng_set(sys.gen, 1);
+	long int reps = state.range(0);
+	while(state.keepRunning()){
+		sink.str("");
+		for(long int r = 0; r < reps; r++){
+			sys.reset(init);
+			sys.simulate(times, "");
+			sys.nextRep();
+		}
+	}
+	state.counters["replicates"] = Counter(reps * state.iterations, Counter::Rate);
+}
+BENCHMARK(BM_ReplicatesSink)->range(1, 1000, 10)->argName("reps");
+
+// Drawing the transition that fires, given its hazards
+static void BM_Choose(State& state){
+	std::vector<double> hazards(state.range(0));
+	for(size_t j = 0; j < hazards.size(); j++)
+		hazards[j] = 1 + j % 7;
+	gsl_rng_set(rng, 1);
+	while(state.keepRunning())
+		doNotOptimize(choose(hazards, rng));
+	state.counters["draws"] = Counter(state.iterations, Counter::Rate);
+}
+BENCHMARK(BM_Choose)->range(2, 256, 4)->argName("transitions");
+
+// Offspring vector of a fixed update, copied out on every event
+static void BM_UpdateGet(State& state){
+	std::vector<int> offspring(state.range(0), 0);
+	offspring[0] = 2;
+	Update u(offspring);
+	while(state.keepRunning())
+		doNotOptimize(u.get());
+}
+BENCHMARK(BM_UpdateGet)->range(1, 64, 4)->argName("types");
@@ -0,0 +1,303 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  main.cpp
+ *
+ *    Description:  Command-line simulator built on the R-independent core
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 17:05:44
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "System.h"
+#include "ModelFile.h"
+#include "ChebyshevRate.h"
+#include "Shard.h"
+#include "Checkpoint.h"
+#include "helpers.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <csignal>
+#include <atomic>
+#include <stdint.h>
+#include <gsl/gsl_rng.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Globals the core expects from its host, defined in Controller.cpp for the R package
+gsl_rng* rng = gsl_rng_alloc(gsl_rng_mt19937);
+bool silent = true;
+
+static void usage(){
+	std::cerr << "usage: estipop-sim [options] model_file\n"
+	          << "  -r, --reps N          number of replicates\n"
+	          << "  -t, --threads N       number of threads\n"
+	          << "  -s, --seed S          global seed; replicate i always uses stream i of it\n"
+	          << "  -o, --output FILE     output file\n"
+	          << "  -f, --format FORMAT   csv, binary or summary\n"
+	          << "  -k, --shard I/N       simulate only the I-th of N replicate ranges (needs a seed)\n"
+	          << "  -c, --checkpoint FILE record progress in FILE after every batch of 1000 replicates per thread and on\n"
+	          << "                        interrupt; a resumed run repeats the replicates of the batch it stopped in\n"
+	          << "  -R, --resume          continue the run recorded in the checkpoint file instead of starting over\n"
+	          << "  -q, --quiet           no progress messages\n"
+	          << "  -h, --help            this message\n"
+	          << "Settings on the command line override those in the model file. Shards are combined with estipop-merge."
+	          << std::endl;
+}
+
+static void onInterrupt(int){
+	interruptRequested = 1;
+}
+
+// Summary accumulators flattened into the extra values of a checkpoint: per time n, the means, then the co-moments
+static std::vector<double> flatten(const Summary& s){
+	std::vector<double> v;
+	for(size_t t = 0; t < s.times.size(); t++){
+		v.push_back(s.n[t]);
+		v.insert(v.end(), s.mean[t].begin(), s.mean[t].end());
+		v.insert(v.end(), s.comoment[t].begin(), s.comoment[t].end());
+	}
+	return v;
+}
+
+static void unflatten(const std::vector<double>& v, Summary& s){
+	size_t width = 1 + s.ntype + s.ntype * s.ntype;
+	if(v.size() != width * s.times.size())
+		throw std::invalid_argument("Checkpoint summary does not match the model");
+	for(size_t t = 0; t < s.times.size(); t++){
+		const double* x = &v[width * t];
+		s.n[t] = x[0];
+		s.mean[t].assign(x + 1, x + 1 + s.ntype);
+		s.comoment[t].assign(x + 1 + s.ntype, x + width);
+	}
+}
+
+int main(int argc, char** argv){
+	std::string modelPath, output, format, shard, checkpoint;
+	long int reps = -1;
+	int threads = -1;
+	bool seeded = false, quiet = false, resume = false;
+	unsigned long int seed = 0;
+
+	for(int i = 1; i < argc; i++){
+		std::string a = argv[i];
+		bool more = i + 1 < argc;
+		if((a == "-r" || a == "--reps") && more) reps = std::stol(argv[++i]);
+		else if((a == "-t" || a == "--threads") && more) threads = std::stoi(argv[++i]);
+		else if((a == "-s" || a == "--seed") && more){ seed = std::stoul(argv[++i]); seeded = true; }
+		else if((a == "-o" || a == "--output") && more) output = argv[++i];
+		else if((a == "-f" || a == "--format") && more) format = argv[++i];
+		else if((a == "-k" || a == "--shard") && more) shard = argv[++i];
+		else if((a == "-c" || a == "--checkpoint") && more) checkpoint = argv[++i];
+		else if(a == "-R" || a == "--resume") resume = true;
+		else if(a == "-q" || a == "--quiet") quiet = true;
+		else if(a == "-h" || a == "--help"){ usage(); return 0; }
+		else if(a[0] != '-' && modelPath.empty()) modelPath = a;
+		else { usage(); return 2; }
+	}
+	if(modelPath.empty()){
+		usage();
+		return 2;
+	}
+
+#ifdef ESTIPOP_FAULT_INJECTION
+	// Test builds only: the run stops as if interrupted after this many interrupt checks
+	if(const char* after = std::getenv("ESTIPOP_INTERRUPT_AFTER"))
+		interruptCountdown = std::atol(after);
+#endif
+
+	auto start = std::chrono::steady_clock::now();
+	try{
+		ModelFile model(modelPath);
+		if(reps >= 0) model.reps = reps;
+		if(threads > 0) model.threads = threads;
+		if(seeded){ model.seed = seed; model.seeded = true; }
+		if(!output.empty()) model.output = output;
+		if(!format.empty()) model.format = format;
+		if(model.format != "csv" && model.format != "binary" && model.format != "summary")
+			throw std::invalid_argument("format must be csv, binary or summary");
+		if(!shard.empty()){
+			size_t slash = shard.find('/');
+			if(slash == std::string::npos)
+				throw std::invalid_argument("shard must be given as index/count");
+			model.shard = std::stoi(shard.substr(0, slash));
+			model.shards = std::stoi(shard.substr(slash + 1));
+			if(model.shards < 1 || model.shard < 1 || model.shard > model.shards)
+				throw std::invalid_argument("shard must be an index from 1 to the shard count");
+		}
+		if(model.shards > 1 && !model.seeded)
+			throw std::invalid_argument("Sharded runs need a seed, the same for every shard");
+		if(!checkpoint.empty() && !model.seeded)
+			throw std::invalid_argument("Checkpointed runs need a seed to resume with");
+		if(!model.seeded)
+			model.seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+
+		ShardHeader header;
+		header.format = model.format;
+		header.ntype = model.ntype;
+		header.seed = model.seed;
+		header.reps = model.reps;
+		header.shard = model.shard;
+		header.shards = model.shards;
+		ShardHeader::range(model.reps, model.shard, model.shards, header.first, header.last);
+		header.model = model.fingerprint();
+
+		bool exact = model.constant();
+		bool summarize = model.format == "summary";
+		double horizon = model.times.back();
+		Summary summary(model.ntype, model.times);
+
+		// A checkpoint records the next replicate, the length of the partial output and the summary so far, and is only
+		// written between batches. Replicates in flight are not snapshotted: resuming restarts them, which loses at most
+		// a batch of work. Streams are per replicate, so continuing from it reproduces the uninterrupted run exactly.
+		std::string partial = model.output + ".part";
+		Checkpoint resumePoint;
+		bool resuming = resume && !checkpoint.empty() && resumePoint.read(checkpoint);
+		if(resuming){
+			std::ifstream in(partial, std::ios::binary);
+			if(!in.is_open() || ShardHeader::read(in).line() != header.line())
+				throw std::invalid_argument("Checkpoint " + checkpoint + " belongs to a different run than " + partial);
+			in.close();
+			truncateFile(partial, resumePoint.offset);
+			if(summarize)
+				unflatten(resumePoint.extra, summary);
+		}
+
+		// Written under a temporary name and renamed once complete, so a file with a header is never partial
+		std::ofstream out(partial, resuming ? std::ios::out | std::ios::app | std::ios::binary : std::ios::out | std::ios::trunc | std::ios::binary);
+		if(!out.is_open())
+			throw std::invalid_argument("Unable to open output file " + partial);
+		if(!resuming)
+			header.write(out);
+
+		std::signal(SIGINT, onInterrupt);
+		std::signal(SIGTERM, onInterrupt);
+
+		// failed is set by whichever replicate throws first (an interrupt throws too); keepGoing only ever changes
+		// between batches, so every thread leaves the batch loop after the same batch
+		std::atomic<bool> failed(false);
+		bool keepGoing = true;
+		std::string failure;
+		STATS(SimulationStats stats;)
+		long int firstRep = resuming ? resumePoint.rep - 1 : header.first - 1;
+		long int done = firstRep - (header.first - 1);
+		const long int batch = 1000 * model.threads;
+
+		// Next replicate to simulate is header.first + done, since rows are only ever kept for a prefix of the range
+		auto saveCheckpoint = [&](){
+			out.flush();
+			Checkpoint c;
+			c.rep = header.first + done;
+			c.offset = out.tellp();
+			if(summarize)
+				c.extra = flatten(summary);
+			c.write(checkpoint);
+		};
+
+		if(!quiet) std::cerr << "Simulating replicates " << firstRep + 1 << " to " << header.last << " of " << model.reps
+		                     << " on " << model.threads << " threads..." << std::endl;
+
+		// Each thread owns a System and a generator. Replicate i restarts the generator on stream i of the seed and its
+		// rows are written in replicate order, so the output depends on neither the number of threads nor the sharding.
+		#pragma omp parallel num_threads(model.threads)
+		{
+			System sys(model.initial);
+			model.build(sys);
+			if(!exact && model.surrogate > 0)
+				useSurrogates(sys.rates2, 0, horizon, model.surrogate);
+			gsl_rng* gen = gsl_rng_alloc(gsl_rng_mt19937);
+			sys.gen = gen;
+			std::ostringstream buffer;
+			sys.sink = &buffer;
+			sys.binary = model.format != "csv";
+
+			// Replicates run in batches so that an interrupt is noticed without walking the rest of the range.
+			for(long int first = firstRep; first < header.last && keepGoing; first += batch){
+				long int last = std::min(header.last, first + batch);
+				#pragma omp for ordered schedule(dynamic)
+				for(long int rep = first; rep < last; rep++){
+					if(failed)
+						continue;
+					buffer.str("");
+					sys.reset(model.initial);
+					sys.rep_num = rep + 1;
+					seedStream(gen, model.seed, rep, 0);
+					try{
+						if(exact)
+							sys.simulate(model.times, model.output);
+						else
+							sys.simulate_timedep(model.times, model.output);
+					}
+					catch(std::exception& e){
+						#pragma omp critical
+						{
+							if(!failed) failure = e.what();
+							failed = true;
+						}
+						continue;
+					}
+					#pragma omp ordered
+					if(!failed){
+						if(summarize)
+							summary.addRows(buffer.str());
+						else
+							out << buffer.str();
+						done++;
+					}
+				}
+				// The barrier closing the single publishes keepGoing to every thread before any of them tests it
+				#pragma omp single
+				{
+					keepGoing = !failed;
+					if(!checkpoint.empty() && keepGoing)
+						saveCheckpoint();
+				}
+			}
+			// Each thread counted into its own System, so this is the only place the counters are shared
+			#ifdef ESTIPOP_STATS
+			#pragma omp critical
+			stats.merge(sys.stats);
+			#endif
+			gsl_rng_free(gen);
+		}
+		if(failed && !checkpoint.empty())
+			saveCheckpoint();
+		if(summarize)
+			summary.write(out);
+		out.close();
+
+		double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if(failed){
+			std::cerr << (interruptRequested ? "interrupted!" : failure) << " " << done << " replicates kept in " << partial << std::endl;
+			return interruptRequested ? 130 : 1;
+		}
+		if(std::rename(partial.c_str(), model.output.c_str()) != 0)
+			throw std::runtime_error("Unable to rename " + partial + " to " + model.output);
+		if(!checkpoint.empty())
+			std::remove(checkpoint.c_str());
+		if(!quiet) std::cerr << done << " replicates written to " << model.output << " in " << elapsed << " s" << std::endl;
+		STATS(if(!quiet) stats.print(std::cerr);)
+	}
+	catch(std::exception& e){
+		std::cerr << "estipop-sim: " << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,125 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  merge.cpp
+ *
+ *    Description:  Combines the shards of a sharded estipop-sim run into the single-run output
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 10:58:03
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "Shard.h"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+static void usage(){
+	std::cerr << "usage: estipop-merge -o output shard_file...\n"
+	          << "Rows of csv and binary shards are concatenated in replicate order; summary shards are pooled.\n"
+	          << "All shards of the run must be given, each once." << std::endl;
+}
+
+int main(int argc, char** argv){
+	std::string output;
+	std::vector<std::string> files;
+	for(int i = 1; i < argc; i++){
+		std::string a = argv[i];
+		if((a == "-o" || a == "--output") && i + 1 < argc) output = argv[++i];
+		else if(a == "-h" || a == "--help"){ usage(); return 0; }
+		else if(a[0] != '-') files.push_back(a);
+		else { usage(); return 2; }
+	}
+	if(output.empty() || files.empty()){
+		usage();
+		return 2;
+	}
+
+	try{
+		std::vector<ShardHeader> headers;
+		for(size_t f = 0; f < files.size(); f++){
+			std::ifstream in(files[f], std::ios::binary);
+			if(!in.is_open())
+				throw std::invalid_argument("Unable to open " + files[f]);
+			headers.push_back(ShardHeader::read(in));
+
+			// A hand-edited or damaged header must still name one shard of the run and exactly its replicates
+			const ShardHeader& h = headers.back();
+			if(h.shards < 1 || h.shard < 1 || h.shard > h.shards)
+				throw std::invalid_argument(files[f] + " names shard " + std::to_string(h.shard) + " of " + std::to_string(h.shards));
+			long int first, last;
+			ShardHeader::range(h.reps, h.shard, h.shards, first, last);
+			if(h.first != first || h.last != last)
+				throw std::invalid_argument(files[f] + " holds replicates " + std::to_string(h.first) + " to " + std::to_string(h.last) +
+				                            " but shard " + std::to_string(h.shard) + " of " + std::to_string(h.shards) + " is " +
+				                            std::to_string(first) + " to " + std::to_string(last));
+		}
+
+		// Shards must come from one run: same model, seed, replicate count and split, each shard exactly once
+		const ShardHeader& h0 = headers[0];
+		std::vector<int> order(h0.shards, -1);
+		for(size_t f = 0; f < files.size(); f++){
+			const ShardHeader& h = headers[f];
+			if(h.format != h0.format || h.ntype != h0.ntype || h.seed != h0.seed || h.reps != h0.reps || h.model != h0.model)
+				throw std::invalid_argument(files[f] + " is not from the same run as " + files[0]);
+			if(h.shards != h0.shards)
+				throw std::invalid_argument(files[f] + " uses a different shard count than " + files[0]);
+			if(order[h.shard - 1] >= 0)
+				throw std::invalid_argument(files[f] + " repeats shard " + std::to_string(h.shard));
+			order[h.shard - 1] = f;
+		}
+		for(int s = 0; s < h0.shards; s++)
+			if(order[s] < 0)
+				throw std::invalid_argument("Shard " + std::to_string(s + 1) + " of " + std::to_string(h0.shards) + " is missing");
+
+		ShardHeader merged = h0;
+		merged.shard = merged.shards = 1;
+		merged.first = 1;
+		merged.last = h0.reps;
+
+		std::string partial = output + ".part";
+		std::ofstream out(partial, std::ios::out | std::ios::trunc | std::ios::binary);
+		if(!out.is_open())
+			throw std::invalid_argument("Unable to open output file " + partial);
+		merged.write(out);
+
+		Summary total(h0.ntype, std::vector<double>());
+		for(int s = 0; s < h0.shards; s++){
+			std::ifstream in(files[order[s]], std::ios::binary);
+			ShardHeader::read(in);
+			if(h0.format != "summary"){
+				if(in.peek() != EOF)
+					out << in.rdbuf();
+			} else if(s == 0){
+				total.read(in);
+			} else {
+				Summary part(h0.ntype, std::vector<double>());
+				part.read(in);
+				total.merge(part);
+			}
+		}
+		if(h0.format == "summary")
+			total.write(out);
+		out.close();
+
+		if(std::rename(partial.c_str(), output.c_str()) != 0)
+			throw std::runtime_error("Unable to rename " + partial + " to " + output);
+	}
+	catch(std::exception& e){
+		std::cerr << "estipop-merge: " << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
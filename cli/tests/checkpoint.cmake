@@ -0,0 +1,50 @@
+# estipop-sim resumes an interrupted run to exactly the output of an uninterrupted one, and refuses to resume onto the
+# partial output of a different run. Run by ctest with -DSIM=<estipop-sim-faults> -DDIR=<scratch directory>.
+file(REMOVE_RECURSE ${DIR})
+file(MAKE_DIRECTORY ${DIR})
+file(WRITE ${DIR}/model.txt "types 2\ninitial 50 0\ntimes 1 2 3\nreps 400\nthreads 2\n"
+                            "transition 1 1.0 -> 2 0\ntransition 1 0.8 -> 0 0\ntransition 1 0.1 -> 1 1\ntransition 2 0.2 -> 0 0\n")
+
+function(sim expected)
+	execute_process(COMMAND ${CMAKE_COMMAND} -E env ${SIM} -q -s 7 ${ARGN} ${DIR}/model.txt RESULT_VARIABLE rc ERROR_VARIABLE err)
+	if(NOT rc EQUAL expected)
+		message(FATAL_ERROR "estipop-sim ${ARGN} returned ${rc}, expected ${expected}: ${err}")
+	endif()
+	set(err "${err}" PARENT_SCOPE)
+endfunction()
+
+foreach(format csv binary summary)
+	sim(0 -f ${format} -o ${DIR}/full.${format})
+
+	# ESTIPOP_INTERRUPT_AFTER stops the run part way, as SIGINT would
+	set(out -f ${format} -o ${DIR}/run.${format} -c ${DIR}/run.ckpt)
+	execute_process(COMMAND ${CMAKE_COMMAND} -E env ESTIPOP_INTERRUPT_AFTER=20000 ${SIM} -q -s 7 ${out} ${DIR}/model.txt
+	                RESULT_VARIABLE rc ERROR_VARIABLE err)
+	if(NOT rc EQUAL 130 OR NOT EXISTS ${DIR}/run.ckpt OR NOT EXISTS ${DIR}/run.${format}.part)
+		message(FATAL_ERROR "${format}: the interrupted run returned ${rc} and left no checkpoint: ${err}")
+	endif()
+
+	# a different seed makes a different header, so its checkpoint cannot continue this partial output
+	execute_process(COMMAND ${SIM} -q -s 8 ${out} -R ${DIR}/model.txt RESULT_VARIABLE rc ERROR_VARIABLE err)
+	if(NOT rc EQUAL 1 OR NOT err MATCHES "belongs to a different run")
+		message(FATAL_ERROR "${format}: resuming with another seed returned ${rc}: ${err}")
+	endif()
+
+	sim(0 ${out} -R)
+	if(EXISTS ${DIR}/run.ckpt)
+		message(FATAL_ERROR "${format}: the checkpoint outlived the completed run")
+	endif()
+	execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${DIR}/full.${format} ${DIR}/run.${format} RESULT_VARIABLE diff)
+	if(NOT diff EQUAL 0)
+		message(FATAL_ERROR "${format}: the resumed run differs from the uninterrupted one")
+	endif()
+endforeach()
+
+# the partial output must be present to resume onto
+set(out -o ${DIR}/gone.csv -c ${DIR}/gone.ckpt)
+execute_process(COMMAND ${CMAKE_COMMAND} -E env ESTIPOP_INTERRUPT_AFTER=20000 ${SIM} -q -s 7 ${out} ${DIR}/model.txt RESULT_VARIABLE rc)
+file(REMOVE ${DIR}/gone.csv.part)
+sim(1 ${out} -R)
+if(NOT err MATCHES "belongs to a different run")
+	message(FATAL_ERROR "resuming without the partial output reported: ${err}")
+endif()
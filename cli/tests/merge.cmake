@@ -0,0 +1,37 @@
+# estipop-merge pools shards of one run and rejects headers that do not describe a shard of it.
+# Run by ctest with -DMERGE=<estipop-merge> -DDIR=<scratch directory>.
+file(REMOVE_RECURSE ${DIR})
+file(MAKE_DIRECTORY ${DIR})
+
+# 5 replicates in 2 shards: 1 to 3 and 4 to 5
+function(shard name spec first last)
+	file(WRITE ${DIR}/${name} "# estipop-sim format=csv types=1 seed=1 reps=5 shard=${spec} first=${first} last=${last} model=0123456789abcdef\n${first},1,3\n")
+endfunction()
+
+function(expect_merge expected message)
+	execute_process(COMMAND ${MERGE} -o ${DIR}/out.csv ${ARGN} RESULT_VARIABLE rc ERROR_VARIABLE err)
+	if(NOT rc EQUAL expected)
+		message(FATAL_ERROR "estipop-merge ${ARGN} returned ${rc}, expected ${expected}: ${err}")
+	endif()
+	if(message AND NOT err MATCHES "${message}")
+		message(FATAL_ERROR "estipop-merge ${ARGN} reported '${err}', expected '${message}'")
+	endif()
+endfunction()
+
+shard(one.csv 1/2 1 3)
+shard(two.csv 2/2 4 5)
+expect_merge(0 "" ${DIR}/two.csv ${DIR}/one.csv)
+file(READ ${DIR}/out.csv merged)
+if(NOT merged STREQUAL "# estipop-sim format=csv types=1 seed=1 reps=5 shard=1/1 first=1 last=5 model=0123456789abcdef\n1,1,3\n4,1,3\n")
+	message(FATAL_ERROR "unexpected merge:\n${merged}")
+endif()
+
+shard(three.csv 3/2 4 5)
+expect_merge(1 "names shard 3 of 2" ${DIR}/one.csv ${DIR}/three.csv)
+shard(zero.csv 0/2 1 3)
+expect_merge(1 "names shard 0 of 2" ${DIR}/zero.csv ${DIR}/two.csv)
+shard(none.csv 1/0 1 5)
+expect_merge(1 "names shard 1 of 0" ${DIR}/none.csv)
+shard(range.csv 2/2 3 5)
+expect_merge(1 "holds replicates 3 to 5 but shard 2 of 2 is 4 to 5" ${DIR}/one.csv ${DIR}/range.csv)
+expect_merge(1 "Shard 2 of 2 is missing" ${DIR}/one.csv)
@@ -0,0 +1,81 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Abc.h
+ *
+ *    Description:  Approximate Bayesian computation by sequential Monte Carlo
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 16:05:33
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+#include <gsl/gsl_rng.h>
+
+#include "Expression.h"
+
+struct AbcGeneration {
+	double tolerance;
+	long int proposals;
+	long int accepted; // proposals within the tolerance, possibly more than were kept
+	long int early; // rejected before every observation was simulated
+	long int overBudget; // rejected for simulating too many events
+	double ess;
+	double seconds;
+};
+
+// ABC-SMC for constant-rate models observed as independent (initial, final) population pairs. A particle's distance
+// is the root mean square difference between simulated and observed log(1 + count) over all observations and types.
+// Observations are simulated one at a time and the running sum only grows, so a particle is dropped as soon as it
+// passes the tolerance. Priors are independent uniforms and proposals perturb a resampled particle with a Gaussian
+// kernel of twice the weighted variance; each tolerance is a quantile of the previous generation's distances.
+class AbcSMC {
+public:
+	// Members
+	std::vector<Expression> rates;
+	std::vector<int> from;
+	std::vector<std::vector<int> > deltas;
+	int ntype;
+	int nparam;
+	int nobs;
+	std::vector<long int> initPop; // nobs x ntype, row-major
+	std::vector<double> target; // log(1 + final population), row-major
+	std::vector<double> durations;
+	std::vector<double> lower;
+	std::vector<double> upper;
+	long int maxEvents;
+
+	std::vector<double> particles; // nparticles x nparam, row-major
+	std::vector<double> weights;
+	std::vector<double> distances;
+	std::vector<AbcGeneration> history;
+	bool complete;
+
+	// Constructors
+	AbcSMC(std::vector<Expression> rates, std::vector<int> from, std::vector<std::vector<int> > offspring, int ntype,
+	       std::vector<long int> initPop, std::vector<long int> finalPop, std::vector<double> durations,
+	       std::vector<double> lower, std::vector<double> upper, long int maxEvents);
+	~AbcSMC();
+
+	// Methods
+	// Distance of theta from the data, or infinity with status 1 (past tol) or 2 (over the event budget)
+	double distance(const double* theta, double tol, gsl_rng* r, int& status) const;
+
+	void run(int nparticles, int ngen, double quantile, long int maxProposals, int threads, unsigned long int seed);
+
+private:
+	bool propose(int gen, const std::vector<double>& cumWeights, const std::vector<double>& sigma, gsl_rng* r, double* theta) const;
+	void reweight(const std::vector<double>& prevParticles, const std::vector<double>& prevWeights, const std::vector<double>& sigma, int threads);
+};
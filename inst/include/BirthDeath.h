@@ -0,0 +1,49 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  BirthDeath.h
+ *
+ *    Description:  Exact transition law of the linear birth-death process
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 14:05:33
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+#include <gsl/gsl_rng.h>
+
+// Single-type linear birth-death process with piecewise-constant rates: birth[k] and death[k] apply from breaks[k] to
+// breaks[k+1], the last piece without end. Over a piece of length t, each individual leaves no descendants with
+// probability alpha and otherwise a geometric number with parameter 1 - beta, so N(t) given N(0) = n is K + NegBin(K,
+// 1 - beta) with K ~ Binomial(n, 1 - alpha). Observations are sampled one from the next without simulating events.
+class BirthDeath {
+public:
+	// Members
+	std::vector<double> breaks;
+	std::vector<double> birth;
+	std::vector<double> death;
+
+	// Constructors
+	BirthDeath(std::vector<double> breaks, std::vector<double> birth, std::vector<double> death);
+	~BirthDeath();
+
+	// Methods
+	// Population at time end given n at time start; if it dies out, extinct is set to the time it does
+	long int sample(long int n, double start, double end, gsl_rng* r, double& extinct) const;
+	void simulate(long int init, std::vector<double> obsTimes, int reps, std::string file, gsl_rng* r) const;
+
+private:
+	long int samplePiece(long int n, double lambda, double mu, double t, gsl_rng* r, double& extinct) const;
+};
@@ -0,0 +1,57 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  CalendarQueue.h
+ *
+ *    Description:  Bucketed event queue for per-individual scheduled events
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 15:02:44
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+// Calendar queue over a fixed horizon [start, end]. Events are bucketed by time; the bucket being drained is
+// heapified once when it becomes current and popped one event at a time, so only events scheduled into the current
+// bucket pay for a heap push. Events after the horizon are never observed and are dropped on push.
+class CalendarQueue {
+public:
+	// 8 bytes per scheduled individual: time relative to its bucket and the individual's type
+	struct Event {
+		float offset;
+		unsigned int type;
+	};
+
+	// Members
+	static const size_t maxBuckets = 65536; // every bucket costs an empty vector, even if nothing is scheduled in it
+
+	double start;
+	double end;
+	double width;
+	size_t current;
+	size_t count;
+	double last;
+	std::vector<std::vector<Event> > buckets;
+
+	// Constructors
+	// nbuckets is clamped to [1, maxBuckets]
+	CalendarQueue(double s, double e, size_t nbuckets);
+	~CalendarQueue();
+
+	// Methods
+	void clear();
+	bool push(double time, unsigned int type);
+	bool pop(double& time, unsigned int& type);
+	size_t size();
+};
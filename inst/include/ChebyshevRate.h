@@ -0,0 +1,61 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  ChebyshevRate.h
+ *
+ *    Description:  Piecewise Chebyshev surrogates for time-dependent rates
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 15:12:40
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+#include "Rate.h"
+
+// Interpolant of another rate on [start, end] using equal-width Chebyshev pieces of fixed degree, stored as power
+// series so evaluation is an index computation and a polynomial over a contiguous coefficient table. Pieces are
+// doubled until each one's error estimate is within the tolerance. The estimate samples the rate between the nodes, so
+// it is not a certified bound for arbitrary rates. Each piece also keeps an upper bound on the interpolant, used as
+// the thinning majorant.
+class ChebyshevRate : public Rate {
+public:
+	// Members
+	static const int degree = 8; // the evaluator is unrolled for this degree
+	static const int maxPieces = 65536;
+
+	double start;
+	double width;
+	double invWidth;
+	int npieces;
+	std::vector<double> coefs; // degree + 1 power series coefficients in u in [-1, 1] per piece
+	std::vector<double> upper; // per piece bound on the interpolant, padded by the error estimate
+	double error; // largest per piece error estimate
+
+	// Constructors
+	ChebyshevRate(Rate& source, double start_time, double end_time, double tol);
+	~ChebyshevRate();
+
+	// Methods
+	virtual double operator()(double time);
+
+	virtual void fillMajorant(double start_time, double end_time, int bins, std::vector<double>& maxes, double buffer);
+
+private:
+	void fit(Rate& source, int pieces);
+};
+
+// Replace every rate that is not constant with a surrogate on [start_time, end_time]; returns the error estimates of
+// the surrogates, in rate order
+std::vector<double> useSurrogates(std::vector<Rate*>& rates, double start_time, double end_time, double tol);
@@ -0,0 +1,56 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Checkpoint.h
+ *
+ *    Description:  Binary snapshots of a replicate loop, for resuming long simulations
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 13:40:55
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+#include <gsl/gsl_rng.h>
+
+// Everything a replicate loop needs to continue bit-identically: the replicate number, the population, time and next
+// observation index at the top of an event loop iteration, the generator state and the size the output had reached.
+// extra carries whatever else the host keeps between replicates, such as summary accumulators.
+struct Checkpoint {
+	int rep;
+	double time;
+	int obs;
+	std::vector<long int> state;
+	std::string rngName;
+	std::vector<char> rngState;
+	long long offset;
+	std::vector<double> extra;
+
+	Checkpoint();
+
+	void saveRng(const gsl_rng* r);
+	void restoreRng(gsl_rng* r) const;
+
+	// Written to file.tmp and renamed over file, so an interruption while writing leaves the previous snapshot
+	void write(const std::string& file) const;
+
+	// False when the file does not exist
+	bool read(const std::string& file);
+};
+
+// Size of a file in bytes, 0 if it does not exist
+long long fileSize(const std::string& file);
+
+// Cut a file back to its first size bytes, dropping output written after a snapshot
+void truncateFile(const std::string& file, long long size);
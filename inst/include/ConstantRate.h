@@ -99,6 +99,8 @@ PulseRate(double totPeriod, double lowPeriod, double low, double high);
 
 virtual double operator()(double time);
 
+virtual double period();
+
 };
 
 
@@ -0,0 +1,42 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Emission.h
+ *
+ *    Description:  Observation densities for noisy population counts
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 17:02:18
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+// Density of an observed count y given the true population x of one type
+typedef double (*EmissionFunction)(double y, double x, const double* params);
+
+class Emission {
+public:
+	// Members
+	int type; // 0 (exact), 1 (poisson), 2 (binomial), 3 (negbin), 4 (gaussian), 5 (custom)
+	std::vector<double> params;
+	EmissionFunction custom; // log density from a plugin library, for type 5
+
+	// Constructors
+	Emission();
+	Emission(std::string dist, std::vector<double> p, EmissionFunction f = nullptr);
+	~Emission();
+
+	// Methods
+	double logDensity(double y, double x) const;
+};
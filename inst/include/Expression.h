@@ -0,0 +1,50 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Expression.h
+ *
+ *    Description:  Rate expressions compiled to reverse Polish notation
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 16:05:33
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+// Opcodes written by generate_rpn
+enum ExpressionOp {
+	OP_CONST = 0, OP_TIME, OP_PARAM, OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW, OP_NEG,
+	OP_EXP, OP_LOG, OP_SIN, OP_COS, OP_LT, OP_GT, OP_LE, OP_GE
+};
+
+// A rate expression of t and params that can be re-evaluated for new parameters without going back to R.
+// values holds the constant for OP_CONST and the 0-based index for OP_PARAM.
+class Expression {
+public:
+	// Members
+	static const int maxDepth = 64;
+
+	std::vector<int> ops;
+	std::vector<double> values;
+
+	// Constructors
+	Expression();
+	Expression(std::vector<int> o, std::vector<double> v);
+	~Expression();
+
+	// Methods
+	double eval(double time, const double* params) const;
+	bool timeDependent() const;
+	int maxParam() const; // largest parameter index used, -1 if none
+};
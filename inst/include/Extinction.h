@@ -0,0 +1,48 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Extinction.h
+ *
+ *    Description:  Extinction probabilities from the backward Kolmogorov equation of the
+ *                  offspring generating function
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 14:05:37
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+#include "Rate.h"
+
+class ExtinctionSolver {
+public:
+	// Members
+	int ntype;
+	std::vector<Rate*> rates;
+	std::vector<int> from;
+	std::vector<std::vector<int> > offspring;
+	bool homogeneous; // true when every rate is a ConstantRate
+	double horizon; // observation time of the current backward solve
+
+	// Constructors
+	ExtinctionSolver(int n);
+	~ExtinctionSolver();
+
+	// Methods
+	void addTransition(Rate* r, int f, std::vector<int> o);
+	void derivative(double tau, const double* q, double* dq);
+
+	// q[k][i] = P(all descendants of one type i cell at time 0 are extinct by times[k])
+	std::vector<std::vector<double> > solve(const std::vector<double>& times);
+};
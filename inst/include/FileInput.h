@@ -0,0 +1,35 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  FileInput.h
+ *
+ *    Description:  Readers for whitespace-separated numbers, line lists and CSV files
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 16:04:12
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+// One row per line of whitespace-separated numbers
+std::vector<std::vector<double> > fileToVectorMatrix(std::string name);
+
+// All numbers in the file, row by row
+std::vector<double> fileToVector(std::string name);
+
+// One string per line, with spaces removed
+std::vector<std::string> inputStringVector(std::string in);
+
+// Comma-separated fields of each line
+std::vector<std::vector<std::string>> funct(std::string filename);
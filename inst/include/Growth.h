@@ -0,0 +1,72 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Growth.h
+ *
+ *    Description:  Malthusian growth rate and stable type distribution
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 15:47:12
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+#include <gsl/gsl_odeiv2.h>
+
+#include "Rate.h"
+
+// Asymptotic growth of the mean population. With constant rates it is the dominant eigenvalue of the mean generator A,
+// A[i][j] the rate at which one type i individual produces type j offspring less, on the diagonal, the rate at which it
+// is replaced (the a_mat of moments()). With rates sharing a period T it is log(rho)/T, rho the dominant Floquet
+// multiplier of the mean over one period. The left eigenvector is the stable type distribution and the right one the
+// reproductive value of each type. Both come from restarted Arnoldi on the action of the operator, so A is never formed
+// densely and the periodic case only integrates vectors over the period.
+class GrowthSolver {
+public:
+	// Members
+	int ntype;
+	std::vector<Rate*> rates;
+	std::vector<int> from;
+	std::vector<std::vector<int> > offspring;
+	bool homogeneous; // true when every rate is a ConstantRate
+	int krylov; // Arnoldi subspace dimension
+	bool transpose; // apply A (right eigenvector) rather than act on row vectors (left eigenvector)
+
+	double growth;
+	double multiplier; // dominant Floquet multiplier, exp(growth) per unit time with constant rates
+	double period;
+	std::vector<double> left; // sums to one
+	std::vector<double> right; // scaled so that left . right = 1
+	int iterations; // operator applications
+	double residual; // largest relative eigen-residual of the two vectors
+
+	// Constructors
+	GrowthSolver(int n);
+	~GrowthSolver();
+
+	// Methods
+	void addTransition(Rate* r, int f, std::vector<int> o);
+	void derivative(double s, const double* x, double* dx);
+	void solve(double period, double tol, int maxRestarts);
+
+private:
+	std::vector<int> rows;
+	std::vector<int> cols;
+	std::vector<double> vals;
+	double shift; // A + shift I is nonnegative with a positive diagonal, so its dominant eigenvalue is the largest in modulus
+	gsl_odeiv2_driver* driver;
+
+	void apply(const std::vector<double>& x, std::vector<double>& y);
+	double arnoldi(std::vector<double>& x, double tol, int maxRestarts);
+};
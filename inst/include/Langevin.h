@@ -0,0 +1,52 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Langevin.h
+ *
+ *    Description:  Chemical Langevin simulation of blocks of replicates in lockstep
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 18:58:27
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+#include "System.h"
+
+// Euler-Maruyama for dX = sum_r nu_r a_r(X) dt + sum_r nu_r sqrt(a_r(X)) dW_r with a_r = rate_r(t) X_parent.
+// A block of replicates is stored structure-of-arrays (x[type * lanes + lane]) and advanced together, so the inner
+// loops run over contiguous lanes. Populations are absorbed at zero.
+class LangevinBlock {
+public:
+	// Members
+	System& sys;
+	int ntype;
+	int lanes;
+	std::vector<std::vector<int> > deltas;
+	std::vector<double> x;
+	std::vector<double> a; // increment of each transition, per lane
+	std::vector<double> z; // standard normals per lane
+	std::vector<char> active;
+	std::vector<std::string> rows; // output of each lane, flushed in replicate order
+
+	// Constructors
+	LangevinBlock(System& s, int l);
+	~LangevinBlock();
+
+	// Methods
+	void normals(int n);
+	void step(double time, double dt);
+	void record(int lane, int rep, double time);
+	void simulate(std::vector<double> obsTimes, std::string file, int firstRep, int nreps, double dt);
+};
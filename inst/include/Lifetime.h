@@ -0,0 +1,39 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Lifetime.h
+ *
+ *    Description:  Lifetime distributions for age-dependent branching processes
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 14:48:12
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+class Lifetime {
+public:
+	// Members
+	int type; // 0 (exponential), 1 (gamma), 2 (lognormal), 3 (empirical)
+	std::vector<double> params;
+
+	// Constructors
+	Lifetime();
+	Lifetime(std::string dist, std::vector<double> p);
+	~Lifetime();
+
+	// Methods
+	double sample();
+	double mean();
+};
@@ -0,0 +1,50 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Likelihood.h
+ *
+ *    Description:  Gaussian moment likelihood of observed populations
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 10:12:40
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+#include <map>
+#include <utility>
+
+
+class MomentTable {
+public:
+	// Members
+	int ntype;
+	int width; // number of state values stored per interval
+	int nparam; // number of parameter sensitivity blocks following the moments
+	std::map<std::pair<double, double>, int> index;
+	std::vector<double> values;
+
+	// Constructors
+	MomentTable(const double* mom, int nrow, int ncol, int n);
+	~MomentTable();
+
+	// Methods
+	const double* find(double tf, double dt) const;
+	void meanCov(const double* row, const double* init, std::vector<double>& mu, std::vector<double>& sigma) const;
+	void meanCovGrad(const double* row, const double* init, int k, std::vector<double>& dmu, std::vector<double>& dsigma) const;
+};
+
+// Sum of multivariate normal log-densities, one Cholesky factorization per distinct (interval, initial population)
+double gaussianLoglik(const MomentTable& mom, const std::vector<double>& init, const std::vector<double>& start,
+                      const std::vector<double>& end, const std::vector<double>& final, int nobs,
+                      std::vector<double>* grad = nullptr);
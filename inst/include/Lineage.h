@@ -0,0 +1,79 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Lineage.h
+ *
+ *    Description:  Clone genealogy recorded in a node arena with incremental pruning
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 16:52:18
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+#include <unordered_map>
+
+struct CloneNode {
+	CloneNode* parent;
+	double time;
+	long long id;
+	int rule; // index of the rule that created the clone, -1 for initial clones
+	int children; // recorded children still in the genealogy
+	bool alive;
+	int index; // position in the exported arrays
+};
+
+// Bump-pointer allocation from fixed-size blocks; pruned nodes go on a free list and are reused first
+class NodeArena {
+public:
+	// Members
+	std::vector<CloneNode*> blocks;
+	size_t used; // nodes handed out from the last block
+	std::vector<CloneNode*> freed;
+	static const size_t blockSize = 4096;
+
+	// Constructors
+	NodeArena();
+	~NodeArena();
+
+	// Methods
+	CloneNode* alloc();
+	void release(CloneNode* node);
+	void clear();
+};
+
+// Clone births and extinctions of one replicate. A clone is dropped as soon as it is extinct and has no recorded
+// children left, so the arena holds only the genealogy of surviving clones.
+class Lineage {
+public:
+	// Members
+	NodeArena arena;
+	std::unordered_map<long long, CloneNode*> live;
+	size_t size;
+
+	// Constructors
+	Lineage();
+	~Lineage();
+
+	// Methods
+	void clear();
+	void root(long long id);
+	void birth(long long id, long long parent, double time, int rule);
+	void extinct(long long id);
+
+	// Surviving genealogy sorted by birth time; parent holds indices into the same arrays, -1 for roots
+	void collect(std::vector<long long>& id, std::vector<int>& parent, std::vector<double>& time, std::vector<int>& rule);
+
+private:
+	void prune(CloneNode* node);
+};
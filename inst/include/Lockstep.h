@@ -0,0 +1,67 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Lockstep.h
+ *
+ *    Description:  Exact SSA advancing several replicates together in lanes
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 19:40:55
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+#include <map>
+#include <set>
+
+#include "System.h"
+
+// Gillespie's direct method for constant rates with one replicate per lane. Propensities, waiting times, event
+// selection and state updates are computed for all lanes at once without per-lane branches; a lane that finishes its
+// replicate is refilled with the next one. Rows are buffered and written in replicate order, as gmbp3 writes them.
+class LockstepSSA {
+public:
+	// Members
+	System& sys;
+	int ntype;
+	int nrates;
+	int lanes;
+	std::vector<std::vector<double> > deltas;
+
+	// Lane state, structure-of-arrays
+	std::vector<double> x; // x[type * lanes + lane]
+	std::vector<double> a; // a[transition * lanes + lane]
+	std::vector<double> total;
+	std::vector<double> u;
+	std::vector<double> wait;
+	std::vector<double> time;
+	std::vector<int> event;
+	std::vector<int> rep; // 0 when the lane is idle
+	std::vector<size_t> obsIndex;
+	std::vector<char> live; // running a replicate and taking this iteration's event
+
+	std::map<int, std::string> pending;
+	std::set<int> completed;
+	int nextRep;
+	int nextWrite;
+
+	// Constructors
+	LockstepSSA(System& s, int w);
+	~LockstepSSA();
+
+	// Methods
+	void fill(int lane, int r);
+	void record(int lane, double t);
+	void finish(int lane, int reps, std::ofstream& of);
+	void simulate(std::vector<double> obsTimes, std::string file, int reps);
+};
@@ -0,0 +1,74 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  MLMC.h
+ *
+ *    Description:  Multilevel Monte Carlo with coupled tau-leap and exact paths
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 18:12:03
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+#include "System.h"
+
+struct LevelStats {
+	double step; // tau-leap step of the fine path, 0 for the exact correction level
+	long int samples;
+	double sum;
+	double sumSq;
+	double seconds;
+
+	double mean() const;
+	double variance() const;
+	double cost() const; // seconds per sample
+};
+
+// Expectation of f(X(T)), f either a weighted sum of the populations or the indicator of extinction. Level 0 is a
+// tau-leap path with step h0; level l adds the difference between steps h0/M^l and h0/M^(l-1), coupled through shared
+// Poisson increments; the last level is exact SSA minus the finest tau-leap, which removes the bias altogether. Each
+// path of a coupled pair is distributed as the uncoupled path of its step, counts applied and clamped once per step.
+class MLMC {
+public:
+	// Members
+	std::vector<double> rates;
+	std::vector<int> from;
+	std::vector<std::vector<int> > deltas;
+	std::vector<long int> init;
+	std::vector<double> weights;
+	bool extinct;
+	double horizon;
+	double h0;
+	int refine;
+	int nlevels; // tau-leap levels; the exact correction is level nlevels
+	std::vector<LevelStats> stats;
+
+	// Constructors
+	MLMC(System& sys, std::vector<long int> init, double horizon, std::vector<double> weights, bool extinct, double h0, int refine, int nlevels);
+	~MLMC();
+
+	// Methods
+	double f(const std::vector<long int>& x);
+	double sampleLevel(int level);
+	void run(int level, long int n);
+	void estimate(double rmse, long int pilot);
+
+private:
+	void propensities(const std::vector<long int>& x, std::vector<double>& a);
+	void apply(std::vector<long int>& x, std::vector<long int>& counts);
+	double tauLeap(double h);
+	double coupledTauLeap(double hf);
+	double coupledExact(double h);
+};
@@ -0,0 +1,95 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  ModelFile.h
+ *
+ *    Description:  Simulation jobs read from plain-text model files, without R
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 16:31:08
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+#include "System.h"
+#include "Rate.h"
+#include "StopCriterion.h"
+
+// One line per setting, '#' starts a comment. Type indices are 1-based as in R.
+//
+//   types 2
+//   initial 100 0                    (any list of numbers may instead be @file, read with fileToVector)
+//   times 1 2 5 10
+//   transition 1 0.5 -> 2 0          (parent, rate, offspring vector)
+//   transition 1 linear 0.1 0.01 -> 0 0
+//   transition 1 switch 0.5 0.1 10 -> 2 0
+//   transition 1 pulse 24 12 0.1 0.9 -> 2 0
+//   transition 2 plugin ./rate.so rate -> 0 2
+//   stop 1 2 >= 100000               (types to sum, inequality, value)
+//   reps 1000
+//   threads 4
+//   seed 42
+//   output sims.csv
+//   format csv                       (binary, or summary for the mean and covariance at each observation time)
+//   shard 3 8                        (simulate only the third of eight equal replicate ranges; needs a seed)
+//   surrogate 1e-6                   (tolerance of Chebyshev rate surrogates, 0 for none)
+struct ModelTransition {
+	int parent; // 0-indexed
+	std::string kind; // constant, linear, switch, pulse or plugin
+	std::vector<double> params;
+	std::string library, symbol; // plugin rates only
+	double (*plugin)(double, void*);
+	std::vector<int> offspring;
+};
+
+class ModelFile {
+public:
+	// Members
+	int ntype;
+	std::vector<long int> initial;
+	std::vector<double> times;
+	std::vector<ModelTransition> transitions;
+	std::vector<StopCriterion> stops;
+
+	long int reps;
+	int threads;
+	unsigned long int seed;
+	bool seeded; // false unless the file sets a seed
+	std::string output;
+	std::string format;
+	double surrogate;
+	int shard; // 1-based
+	int shards;
+
+	std::vector<void*> handles; // plugin libraries, closed with the model
+
+	// Constructors
+	ModelFile(std::string file);
+	~ModelFile();
+
+	// Methods
+	// True when every transition has a constant rate, so System::simulate applies
+	bool constant() const;
+
+	// Add the transitions and stopping criteria to sys, with rates owned by sys
+	void build(System& sys) const;
+
+	// Hash of the types, initial population, observation times, transitions and stopping criteria, so that outputs of
+	// different models are never merged
+	std::string fingerprint() const;
+
+private:
+	void parseLine(const std::string& line, int number);
+	void* open(const std::string& location, int number);
+};
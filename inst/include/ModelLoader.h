@@ -0,0 +1,67 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  ModelLoader.h
+ *
+ *    Description:  Builds rates, transitions and stopping criteria from R lists
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 13:20:51
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+#include <Rcpp.h>
+
+#include "System.h"
+#include "Rate.h"
+#include "StopCriterion.h"
+#include "SparseSystem.h"
+#include "Expression.h"
+#include "Emission.h"
+
+// Open plugin libraries, closed once the rates using them are no longer needed
+class PluginHandles {
+public:
+	std::vector<void*> handles;
+
+	PluginHandles();
+	~PluginHandles();
+
+	void* open(const char* location);
+};
+
+// Rate of a transition, either constant (type 1) or a plugin function (type 2)
+Rate* loadRate(Rcpp::List transition, PluginHandles& plugins);
+
+// Parent type (0-indexed) and offspring vector of a transition
+int loadParent(Rcpp::List transition);
+std::vector<int> loadOffspring(Rcpp::List transition);
+
+void loadTransitions(System& sys, Rcpp::List transitions, PluginHandles& plugins);
+void loadConstantTransitions(System& sys, Rcpp::List transitions);
+StopCriterion loadStop(Rcpp::List stop);
+void loadStops(System& sys, Rcpp::List stops);
+
+// One list(dist, params) per type
+void loadLifetimes(System& sys, Rcpp::List lifetimes);
+
+// Rate expression of a transition as list(ops, values), written by generate_rpn
+Expression loadExpression(Rcpp::List transition);
+
+// Observation density as list(dist, params, library, symbol); the last two only for custom densities
+Emission loadEmission(Rcpp::List emission, PluginHandles& plugins);
+
+// One list(rate, same, mutant, mutation) per template rule
+void loadSparseRules(SparseSystem& sys, Rcpp::List rules);
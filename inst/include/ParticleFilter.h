@@ -0,0 +1,64 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  ParticleFilter.h
+ *
+ *    Description:  Bootstrap particle filter for longitudinal count data
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 17:02:18
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+#include <gsl/gsl_rng.h>
+
+#include "System.h"
+#include "Emission.h"
+
+// Likelihood of one trajectory of noisy counts under a constant-rate process, started from a known population.
+// Particles are propagated between observation times by exact simulation, or by tau-leaping while every type with an
+// outgoing transition has at least leapThreshold individuals, then weighted by the emission density of each observed
+// type. Systematic resampling happens whenever the effective sample size drops below essThreshold times the number
+// of particles. The likelihood estimate is unbiased, so it can be used inside particle MCMC.
+class ParticleFilter {
+public:
+	// Members
+	std::vector<double> rates;
+	std::vector<int> from;
+	std::vector<std::vector<int> > deltas;
+	int ntype;
+	std::vector<Emission> emissions; // one per type
+	double leapThreshold;
+	double leapEps; // bound on the expected relative change of a type in one leap
+
+	// Per observation diagnostics of the last run
+	std::vector<double> ess;
+	std::vector<double> increments;
+	std::vector<int> resampled;
+	long int leaps;
+
+	// Constructors
+	ParticleFilter(System& sys, std::vector<Emission> emissions, double leapThreshold);
+	~ParticleFilter();
+
+	// Methods
+	// observed is row-major, one row per time, with NaN for types that were not observed
+	double logLikelihood(const std::vector<long int>& init, const std::vector<double>& times, const std::vector<double>& observed,
+	                     int nparticles, double essThreshold, int threads, unsigned long int seed);
+
+private:
+	long int propagate(long int* x, double dt, std::vector<double>& a, gsl_rng* r) const;
+	double logWeight(const long int* x, const double* y) const;
+};
@@ -0,0 +1,32 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Propagator.h
+ *
+ *    Description:  Composition of moment propagators over adjacent time segments
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 11:02:15
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+// A propagator over [s, t] is the state vector produced by moments(): the mean matrix M (n x n), the second
+// moment array D (n x n x n), then nparam blocks holding their derivatives with respect to each parameter.
+int propagatorWidth(int ntype, int nparam);
+
+void identityPropagator(double* out, int ntype, int nparam);
+
+// Propagator over [s, u] from the propagators over [s, t] (first) and [t, u] (second)
+void composePropagators(const double* first, const double* second, double* out, int ntype, int nparam);
@@ -23,7 +23,6 @@
 #include <sstream>
 #include <vector>
 #include <gsl/gsl_min.h>
-#include <Rcpp.h>
 
 //#include <map>
 
@@ -46,4 +45,10 @@ public:
 	double eval(double time);
 
 	virtual double operator()(double time);
+
+	// Piecewise thinning bounds: maxes[step] bounds the rate from bin step to end_time
+	virtual void fillMajorant(double start_time, double end_time, int bins, std::vector<double>& maxes, double buffer);
+
+	// Period of a periodic rate, 0 if the rate is not known to be periodic
+	virtual double period();
 };
@@ -0,0 +1,62 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Sensitivity.h
+ *
+ *    Description:  Parameter sensitivities of simulated populations
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 09:12:40
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+#include <gsl/gsl_rng.h>
+
+#include "System.h"
+
+// Gradients of the population at the observation times with respect to the model parameters, for constant rates.
+// Paths follow the random time-change representation: transition k fires when its integrated propensity reaches the
+// next point of its own unit Poisson process, driven by a dedicated stream. The nominal path and the path with each
+// parameter stepped reuse the same streams, so finite differences between them are between synchronized paths
+// (common reaction paths). The nominal path also carries the likelihood-ratio score
+// sum_events rate'/rate - integral sum_k rate'_k x_from(k) dt, whose product with a statistic estimates its gradient.
+class Sensitivity {
+public:
+	// Members
+	std::vector<double> rates; // nominal per-capita rates
+	std::vector<int> from;
+	std::vector<std::vector<int> > deltas;
+	std::vector<std::vector<double> > perturbed; // perturbed[j][k]: rate k with parameter j stepped
+	std::vector<std::vector<double> > jacobian; // jacobian[j][k]: derivative of rate k with respect to parameter j
+	int ntype;
+	int nparam;
+
+	// Row-major results, one row per replicate
+	std::vector<double> nominal; // [rep][obs][type]
+	std::vector<double> shifted; // [param][rep][obs][type], when common reaction paths are requested
+	std::vector<double> scores; // [rep][obs][param], when the likelihood ratio is requested
+	long int events;
+
+	// Constructors
+	Sensitivity(System& sys, std::vector<std::vector<double> > perturbed, std::vector<std::vector<double> > jacobian);
+	~Sensitivity();
+
+	// Methods
+	void simulate(const std::vector<long int>& init, const std::vector<double>& obsTimes, int reps, bool crn, bool lr, int threads, unsigned long int seed);
+
+private:
+	long int path(const std::vector<long int>& init, const std::vector<double>& c, const std::vector<double>& obsTimes, gsl_rng** streams,
+	              unsigned long int seed, int rep, double* out, double* score) const;
+};
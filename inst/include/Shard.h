@@ -0,0 +1,80 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Shard.h
+ *
+ *    Description:  Self-describing headers and mergeable summaries of simulator output
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 10:22:37
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+// First line of every output file written by estipop-sim, e.g.
+//   # estipop-sim format=csv types=2 seed=42 reps=1000 shard=3/8 first=251 last=375 model=9c0d3e5a1b2f4c77
+// Replicates first..last (1-based, inclusive) of a run of reps are in the file, replicate i simulated on stream i - 1
+// of the seed, so shards of one run cover disjoint replicates and together reproduce the unsharded run. Binary files
+// hold the same line after the 8 byte magic ESTIPOP1 and its uint32 length.
+struct ShardHeader {
+	std::string format; // csv, binary or summary
+	int ntype;
+	unsigned long int seed;
+	long int reps;
+	int shard; // 1-based
+	int shards;
+	long int first;
+	long int last;
+	std::string model; // fingerprint of the model the rows come from
+
+	ShardHeader();
+
+	// Replicates of shard index of count, split as evenly as possible
+	static void range(long int reps, int index, int count, long int& first, long int& last);
+
+	std::string line() const;
+	static ShardHeader parse(const std::string& line);
+
+	void write(std::ostream& out) const;
+	static ShardHeader read(std::istream& in);
+};
+
+// Per observation time, the number of replicates observed, the mean of each type and the co-moment sums
+// sum (x - mean)(x - mean)^T, updated one replicate at a time and merged with Chan's pairwise formula.
+class Summary {
+public:
+	// Members
+	int ntype;
+	std::vector<double> times;
+	std::vector<double> n;
+	std::vector<std::vector<double> > mean;
+	std::vector<std::vector<double> > comoment; // ntype x ntype, column-major
+
+	// Constructors
+	Summary(int ntype, std::vector<double> times);
+
+	// Methods
+	void add(size_t obs, const long int* state);
+
+	// Add one replicate from its binary System rows. A replicate that ends extinct before the last observation time
+	// is counted as zero at the remaining times; one stopped by a criterion only at the times it reached.
+	void addRows(const std::string& rows);
+
+	void merge(const Summary& other);
+
+	// Lines of time, n, the means, then the covariances cov_i_j for i <= j. read replaces the contents with the
+	// remaining lines of in.
+	void write(std::ostream& out) const;
+	void read(std::istream& in);
+};
@@ -0,0 +1,57 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  SparseState.h
+ *
+ *    Description:  Open-addressing map of live type counts with proportional sampling
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 15:40:09
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+// Counts of the live types only. Linear probing with backward-shift deletion keeps no tombstones, so a type is
+// removed as soon as its count reaches zero. A Fenwick tree over the slots draws a type in proportion to its count.
+class SparseState {
+public:
+	struct Entry {
+		long long id;
+		long int count; // 0 marks an empty slot
+	};
+
+	// Members
+	std::vector<Entry> slots;
+	std::vector<long int> tree;
+	size_t live;
+	long int total;
+
+	// Constructors
+	SparseState();
+	~SparseState();
+
+	// Methods
+	void clear();
+	long int count(long long id);
+	void add(long long id, long int delta);
+	long long sample(double u); // u uniform on [0, 1)
+	std::vector<Entry> entries(); // live types sorted by id
+
+private:
+	size_t home(long long id);
+	size_t find(long long id);
+	void treeAdd(size_t slot, long int delta);
+	void rebuild(size_t capacity);
+	void erase(size_t slot);
+};
@@ -0,0 +1,61 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  SparseSystem.h
+ *
+ *    Description:  Branching process over a dynamic, sparse set of types
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 16:05:31
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+#include "SparseState.h"
+#include "Lineage.h"
+
+// A transition applied to every live type. The parent is replaced by `same` copies of its own type and `mutant`
+// individuals of a mutated type: a never-seen id (novel) or the parent id plus or minus one (step).
+struct SparseRule {
+	double rate;
+	int same;
+	int mutant;
+	int mutation; // 0 (none), 1 (novel), 2 (step)
+};
+
+class SparseSystem {
+public:
+	// Members
+	int rep_num;
+	long long nextId;
+	std::vector<SparseRule> rules;
+	std::vector<double> cumRates;
+	double sumRate;
+	SparseState state;
+	bool recordLineage;
+	Lineage lineage;
+
+	// Constructors
+	SparseSystem();
+	~SparseSystem();
+
+	// Methods
+	void reset(const std::vector<long long>& ids, const std::vector<long int>& counts);
+	void nextRep();
+	void toFile(double time, std::string file);
+	void addRule(SparseRule r);
+	long long mutate(long long parent, int mutation);
+
+	void simulate(std::vector<double> obsTimes, std::string file);
+};
@@ -0,0 +1,40 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Splitting.h
+ *
+ *    Description:  Fixed-effort multilevel splitting for rare target events
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 17:31:46
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+#include "System.h"
+#include "StopCriterion.h"
+
+struct SplitResult {
+	double estimate; // mean of the independent replication estimates
+	double variance; // variance of that mean
+	int replications;
+	std::vector<double> levelProbs; // mean conditional probability of reaching each level from the previous one
+};
+
+// P(target's sum reaches its value before the horizon) for a system with constant rates. Each replication runs
+// `effort` trajectories per stage, restarting from states drawn uniformly among the previous stage's entrances.
+// A product of stage fractions is unbiased, so independent replications run until `budget` seconds are used (at least
+// two) give the variance directly.
+SplitResult multilevelSplitting(System& sys, const std::vector<long int>& init, const StopCriterion& target,
+                                std::vector<double> levels, double horizon, int effort, double budget, int maxReps);
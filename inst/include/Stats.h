@@ -0,0 +1,54 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Stats.h
+ *
+ *    Description:  Per-replicate simulation counters and phase timers
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 10:31:07
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+// Counters are only compiled in with -DESTIPOP_STATS; STATS(...) expands to its argument then and to nothing otherwise.
+#ifdef ESTIPOP_STATS
+#define STATS(...) __VA_ARGS__
+#else
+#define STATS(...)
+#endif
+
+// Where a simulation spends its time. Each System owns one, so threads count without sharing anything, and the
+// host merges them once the threads are done.
+class SimulationStats {
+public:
+	// Members
+	long int replicates = 0;
+	long int stopped = 0; // replicates ended by a stopping criterion
+	long int extinct = 0;
+	std::vector<long int> events; // fired, per transition
+	long int proposals = 0; // thinning candidates drawn from the majorant
+	long int accepts = 0;
+	long int stopChecks = 0; // stopping criteria evaluated
+	long int majorantBuilds = 0;
+	long int rows = 0;
+	long int outputBytes = 0;
+	double majorantSeconds = 0;
+	double outputSeconds = 0;
+	double simulateSeconds = 0; // inside simulate calls, output included
+
+	// Methods
+	void merge(const SimulationStats& other);
+	void print(std::ostream& out) const;
+};
@@ -37,4 +37,7 @@ public:
 	~StopCriterion();
 
 	bool check(std::vector<long int> state);
+
+	// Sum of the selected populations, the quantity compared against value
+	long int level(const std::vector<long int>& state) const;
 };
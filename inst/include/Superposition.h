@@ -0,0 +1,55 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Superposition.h
+ *
+ *    Description:  Large initial populations as sums of single-ancestor outcomes
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 10:41:07
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#pragma once
+#include <string>
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+#include <gsl/gsl_rng.h>
+
+#include "System.h"
+
+// A process started from N ancestors is the sum of N independent single-ancestor processes. The library holds, for each
+// starting type, outcomes of single-ancestor paths at the observation times; a replicate from any initial population is
+// then assembled by resampling library rows and summing them, with no event simulated. Types with more than
+// cltThreshold ancestors contribute a Gaussian draw with the library's mean and covariance scaled by N instead.
+class Superposition {
+public:
+	// Members
+	int ntype;
+	int nobs;
+	int width; // nobs * ntype values per outcome, observation-major
+	std::vector<std::vector<double> > library; // library[i]: size x width outcomes of one type-i ancestor, row-major
+	std::vector<std::vector<double> > mean; // per starting type, empty unless computed by moments
+	std::vector<std::vector<double> > factor; // per starting type, column-major L with L L^T the covariance, likewise
+
+	// Constructors
+	Superposition(int ntype, int nobs);
+	~Superposition();
+
+	// Methods
+	void build(System& sys, const std::vector<double>& obsTimes, int size, int threads, unsigned long int seed);
+	// Library mean and covariance factor of the flagged starting types, the ones sample draws from the Gaussian
+	void moments(const std::vector<bool>& types);
+	void sample(const std::vector<long int>& init, double cltThreshold, gsl_rng* r, double* out) const;
+
+private:
+	long int size(int type) const;
+};
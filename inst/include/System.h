@@ -27,6 +27,12 @@
 #include "Update.h"
 #include "Rate.h"
 #include "StopCriterion.h"
+#include "Lifetime.h"
+#include "Checkpoint.h"
+#include "Stats.h"
+
+#include <chrono>
+#include <gsl/gsl_rng.h>
 
 class System {
 public:
@@ -42,8 +48,37 @@ public:
 	std::vector<Update> updates;
 	std::vector<std::vector<double>> homog_rates;
 
+	// Time-dependent simulation splits transitions into constant rates, sampled exactly, and the rest, thinned
+	std::vector<int> exactIndex;
+	std::vector<double> exactRates;
+	std::vector<int> thinIndex;
+	double majorantEnd = -1; // horizon the homog_rates tables were built for
+
 	std::vector<StopCriterion> stops;
 
+	std::vector<Lifetime> lifetimes; // per type, for age-dependent simulation
+
+	gsl_rng* gen; // generator for this system's draws, the global rng unless replaced
+
+	// When sink is set, toFile writes rows to it instead of appending to the named file. Binary rows are
+	// (int32 rep, double time, int64 count per type) in native byte order.
+	std::ostream* sink = nullptr;
+	bool binary = false;
+
+	// When checkpointFile is set, simulate and simulate_timedep snapshot the replicate at the top of their event loop
+	// every checkpointEvery seconds of wall time, and when interrupted there. After resumeFrom, the next simulate call
+	// continues from the snapshot instead of time 0.
+	std::string checkpointFile;
+	double checkpointEvery = 600;
+	bool resuming = false;
+	Checkpoint resumePoint;
+	long int sinceClock = 0;
+	std::chrono::steady_clock::time_point lastCheckpoint;
+
+	#ifdef ESTIPOP_STATS
+	SimulationStats stats; // reset by the host, never by the System
+	#endif
+
 	// Constructors
 	System();
 	System(std::vector<long int> s);
@@ -62,13 +97,27 @@ public:
 
 	void addStop(StopCriterion c);
 
+	void addLifetime(Lifetime l);
+
 	double getNextTime(std::vector<double>& o_rates);
 
-	double getNextTime2(double curTime, double totTime);
+	void splitClocks(double totTime);
 
-	int getNextEvent2(double curTime, double timeToNext);
+	double getNextTime2(double curTime, double endTime, double totTime, std::vector<double>& o_rates);
 
 	void simulate(std::vector<double> obsTimes, std::string file);
 
 	void simulate_timedep(std::vector<double> obsTimes, std::string file);
+
+	void simulate_age(std::vector<double> obsTimes, std::string file);
+
+	void enableCheckpoints(std::string file, double every);
+	Checkpoint snapshot(double curTime, int curObsIndex, std::string file);
+	void resumeFrom(const Checkpoint& c);
+
+	// Called at the top of each event loop iteration: checks for an interrupt and writes any snapshot that is due
+	void poll(double curTime, int curObsIndex, std::string file);
+
+	// Run from curTime until target's sum reaches level (returns true) or the horizon or extinction comes first
+	bool advance(double& curTime, double endTime, const StopCriterion& target, double level, std::vector<double>& o_rates);
 };
@@ -22,17 +22,53 @@
 #include <ostream>
 #include <vector>
 #include <map>
+#include <csignal>
+#include <atomic>
 #include <gsl/gsl_math.h>
+#include <gsl/gsl_rng.h>
+
+#include "Update.h"
 
 // Helper methods - CellPopulationCode
 std::vector<double> normalize(std::vector<double> input);
 int choose(std::vector<double> input);
+int choose(std::vector<double> input, gsl_rng* gen);
 
 // Rate functions
 double maximizeFunc(gsl_function rate_function, double start_time, double end_time, int bins);
 
 void maximizePiecewise(gsl_function rate_function, double start_time, double end_time, int bins, std::vector<double>& vec, double buffer);
 
+// Linear algebra
+bool cholesky(std::vector<double>& a, int n);
+double forwardSolveNorm(const std::vector<double>& l, int n, std::vector<double>& x);
+void choleskySolve(const std::vector<double>& l, int n, std::vector<double>& x);
+
+// Parallel sampling
+void seedStream(gsl_rng* r, unsigned long int seed, unsigned long int stream, unsigned long int index);
+int threadIndex();
+
+// Gillespie's direct method: the net change of each transition (its offspring less the parent it replaces), and the
+// transition that fires given the propensities a and their sum
+std::vector<std::vector<int> > transitionDeltas(std::vector<std::vector<int> > offspring, const std::vector<int>& from);
+std::vector<std::vector<int> > transitionDeltas(std::vector<Update>& updates, const std::vector<int>& from);
+int chooseTransition(const std::vector<double>& a, double total, gsl_rng* r);
 
+// Rcpp::checkUserInterrupt in the package. Standalone builds have no R session, so they throw once
+// interruptRequested is set, typically from a signal handler.
+void checkInterrupt();
+#ifdef ESTIPOP_STANDALONE
+extern volatile std::sig_atomic_t interruptRequested;
+#ifdef ESTIPOP_FAULT_INJECTION
+// Test builds only: when positive, the checkInterrupt call that brings it to 0 sets interruptRequested
+extern std::atomic<long int> interruptCountdown;
+#endif
+#endif
 
+// One generator per thread, freed on every exit path including interrupts
+struct ThreadRngs {
+	std::vector<gsl_rng*> rngs;
 
+	ThreadRngs(int n);
+	~ThreadRngs();
+};
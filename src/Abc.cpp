@@ -0,0 +1,267 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Abc.cpp
+ *
+ *    Description:  Approximate Bayesian computation by sequential Monte Carlo
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 16:05:33
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+
+#include "Abc.h"
+#include "helpers.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <gsl/gsl_randist.h>
+
+#include <Rcpp.h>
+
+extern bool silent;
+
+AbcSMC::AbcSMC(std::vector<Expression> rates, std::vector<int> from, std::vector<std::vector<int> > offspring, int ntype,
+               std::vector<long int> initPop, std::vector<long int> finalPop, std::vector<double> durations,
+               std::vector<double> lower, std::vector<double> upper, long int maxEvents)
+	: rates(rates), from(from), ntype(ntype), initPop(initPop), durations(durations), lower(lower), upper(upper), maxEvents(maxEvents), complete(false){
+	nparam = lower.size();
+	nobs = durations.size();
+	if(upper.size() != lower.size())
+		throw std::invalid_argument("Need a lower and an upper prior bound for every parameter");
+	if(initPop.size() != (size_t)nobs*ntype || finalPop.size() != (size_t)nobs*ntype)
+		throw std::invalid_argument("Need an initial and a final population for every observation");
+
+	for(size_t r = 0; r < rates.size(); r++){
+		if(rates[r].timeDependent())
+			throw std::invalid_argument("ABC-SMC needs rates that are constant in time");
+		if(rates[r].maxParam() >= nparam)
+			throw std::invalid_argument("A rate uses a parameter without prior bounds");
+	}
+	deltas = transitionDeltas(offspring, from);
+
+	target.resize(finalPop.size());
+	for(size_t i = 0; i < finalPop.size(); i++)
+		target[i] = log1p((double)finalPop[i]);
+}
+
+AbcSMC::~AbcSMC(){}
+
+double AbcSMC::distance(const double* theta, double tol, gsl_rng* r, int& status) const{
+	int nrate = rates.size();
+	std::vector<double> k(nrate), a(nrate);
+	for(int j = 0; j < nrate; j++)
+		k[j] = std::max(0.0, rates[j].eval(0, theta));
+
+	double bound = tol*tol*nobs*ntype;
+	double sum = 0;
+	long int events = 0;
+	std::vector<long int> x(ntype);
+	status = 0;
+
+	for(int obs = 0; obs < nobs; obs++){
+		std::copy(initPop.begin() + obs*ntype, initPop.begin() + (obs + 1)*ntype, x.begin());
+
+		double t = 0;
+		while(true){
+			double total = 0;
+			for(int j = 0; j < nrate; j++){
+				a[j] = k[j]*x[from[j]];
+				total += a[j];
+			}
+			if(total <= 0)
+				break;
+
+			t += gsl_ran_exponential(r, 1/total);
+			if(t > durations[obs])
+				break;
+
+			if(++events > maxEvents){
+				status = 2;
+				return std::numeric_limits<double>::infinity();
+			}
+
+			int j = chooseTransition(a, total, r);
+			for(int i = 0; i < ntype; i++){
+				x[i] += deltas[j][i];
+				if(x[i] < 0)
+					x[i] = 0;
+			}
+		}
+
+		for(int i = 0; i < ntype; i++){
+			double d = log1p((double)x[i]) - target[obs*ntype + i];
+			sum += d*d;
+		}
+		if(sum > bound){
+			status = 1;
+			return std::numeric_limits<double>::infinity();
+		}
+	}
+	return std::sqrt(sum/(nobs*ntype));
+}
+
+bool AbcSMC::propose(int gen, const std::vector<double>& cumWeights, const std::vector<double>& sigma, gsl_rng* r, double* theta) const{
+	if(gen == 0){
+		for(int p = 0; p < nparam; p++)
+			theta[p] = lower[p] + (upper[p] - lower[p])*gsl_rng_uniform(r);
+		return true;
+	}
+
+	// Perturbed particles outside the prior have zero density and are redrawn
+	for(int tries = 0; tries < 1000; tries++){
+		double u = gsl_rng_uniform(r)*cumWeights.back();
+		int j = std::upper_bound(cumWeights.begin(), cumWeights.end(), u) - cumWeights.begin();
+		j = std::min(j, (int)cumWeights.size() - 1);
+
+		bool inside = true;
+		for(int p = 0; p < nparam; p++){
+			theta[p] = particles[j*nparam + p] + (sigma[p] > 0 ? gsl_ran_gaussian(r, sigma[p]) : 0);
+			if(theta[p] < lower[p] || theta[p] > upper[p])
+				inside = false;
+		}
+		if(inside)
+			return true;
+	}
+	return false;
+}
+
+// w_i proportional to prior(theta_i) / sum_j w_j K(theta_i | theta_j); the uniform prior and the kernel's
+// normalizing constant are the same for every particle and cancel
+void AbcSMC::reweight(const std::vector<double>& prevParticles, const std::vector<double>& prevWeights, const std::vector<double>& sigma, int threads){
+	int n = weights.size();
+	int m = prevWeights.size();
+
+	#pragma omp parallel for num_threads(threads) schedule(static)
+	for(int i = 0; i < n; i++){
+		double denom = 0;
+		for(int j = 0; j < m; j++){
+			double q = 0;
+			for(int p = 0; p < nparam; p++){
+				if(sigma[p] > 0){
+					double z = (particles[i*nparam + p] - prevParticles[j*nparam + p])/sigma[p];
+					q += z*z;
+				}
+			}
+			denom += prevWeights[j]*exp(-q/2);
+		}
+		weights[i] = denom > 0 ? 1/denom : 0;
+	}
+
+	double total = std::accumulate(weights.begin(), weights.end(), 0.0);
+	for(int i = 0; i < n; i++)
+		weights[i] /= total;
+}
+
+void AbcSMC::run(int nparticles, int ngen, double quantile, long int maxProposals, int threads, unsigned long int seed){
+	ThreadRngs rngs(threads);
+	complete = false;
+	history.clear();
+
+	for(int gen = 0; gen < ngen; gen++){
+		auto start = std::chrono::steady_clock::now();
+		AbcGeneration stats = {std::numeric_limits<double>::infinity(), 0, 0, 0, 0, 0, 0};
+
+		// Tolerance and kernel from the previous generation
+		std::vector<double> cumWeights, sigma(nparam, 0.0);
+		if(gen > 0){
+			std::vector<double> sorted(distances);
+			std::sort(sorted.begin(), sorted.end());
+			stats.tolerance = sorted[std::min((size_t)(quantile*sorted.size()), sorted.size() - 1)];
+
+			cumWeights.resize(weights.size());
+			std::partial_sum(weights.begin(), weights.end(), cumWeights.begin());
+			for(int p = 0; p < nparam; p++){
+				double mean = 0, var = 0;
+				for(size_t i = 0; i < weights.size(); i++)
+					mean += weights[i]*particles[i*nparam + p];
+				for(size_t i = 0; i < weights.size(); i++)
+					var += weights[i]*(particles[i*nparam + p] - mean)*(particles[i*nparam + p] - mean);
+				sigma[p] = std::sqrt(2*var);
+			}
+		}
+
+		std::vector<double> kept, keptDist;
+		long int done = 0, acc = 0;
+		while(acc < nparticles && done < maxProposals){
+			// Size the batch from the acceptance rate so far
+			long int need = nparticles - acc;
+			long int batch = acc > 0 ? (long int)std::ceil(1.1*need*done/acc) : (done > 0 ? 2*done : need);
+			batch = std::min(std::max(batch, 8L*threads), maxProposals - done);
+
+			std::vector<double> cand(batch*nparam), dist(batch);
+			std::vector<int> status(batch);
+
+			#pragma omp parallel for num_threads(threads) schedule(dynamic, 4)
+			for(long int b = 0; b < batch; b++){
+				gsl_rng* r = rngs.rngs[threadIndex()];
+				seedStream(r, seed, gen, done + b);
+				if(propose(gen, cumWeights, sigma, r, &cand[b*nparam]))
+					dist[b] = distance(&cand[b*nparam], stats.tolerance, r, status[b]);
+				else {
+					// No perturbation landed inside the prior; counted with the early rejections
+					dist[b] = std::numeric_limits<double>::infinity();
+					status[b] = 1;
+				}
+			}
+
+			// Keep in proposal order so the sample does not depend on scheduling
+			for(long int b = 0; b < batch; b++){
+				if(status[b] == 1)
+					stats.early++;
+				else if(status[b] == 2)
+					stats.overBudget++;
+				else if(dist[b] <= stats.tolerance){
+					stats.accepted++;
+					if(acc < nparticles){
+						kept.insert(kept.end(), cand.begin() + b*nparam, cand.begin() + (b + 1)*nparam);
+						keptDist.push_back(dist[b]);
+						acc++;
+					}
+				}
+			}
+			done += batch;
+			Rcpp::checkUserInterrupt();
+		}
+		stats.proposals = done;
+		stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		if(acc < nparticles){
+			history.push_back(stats);
+			if(!silent)
+				std::cout << "Generation " << gen + 1 << " accepted " << acc << " of " << nparticles << " particles within the proposal limit. Stopping..." << std::endl;
+			return;
+		}
+
+		std::vector<double> prevParticles, prevWeights;
+		prevParticles.swap(particles);
+		prevWeights.swap(weights);
+		particles.swap(kept);
+		distances.swap(keptDist);
+		weights.assign(nparticles, 1.0/nparticles);
+		if(gen > 0)
+			reweight(prevParticles, prevWeights, sigma, threads);
+
+		double sumSq = 0;
+		for(int i = 0; i < nparticles; i++)
+			sumSq += weights[i]*weights[i];
+		stats.ess = 1/sumSq;
+		stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		history.push_back(stats);
+
+		if(!silent)
+			std::cout << "Generation " << gen + 1 << ": tolerance " << stats.tolerance << ", acceptance " << (double)stats.accepted/stats.proposals << ", ESS " << stats.ess << std::endl;
+	}
+	complete = true;
+}
@@ -0,0 +1,118 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  BirthDeath.cpp
+ *
+ *    Description:  Exact transition law of the linear birth-death process
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 14:05:33
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "BirthDeath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <gsl/gsl_randist.h>
+
+#include <Rcpp.h>
+
+extern bool silent;
+
+// GSL draws counts as unsigned int. Larger ones are sums of independent draws that each fit; smaller ones make the
+// same calls as gsl_ran_binomial and gsl_ran_negative_binomial, so seeded results do not change.
+static long int binomial(gsl_rng* r, double p, long int n){
+	const long int chunk = 2000000000L;
+	long int k = 0;
+	for(; n > chunk; n -= chunk)
+		k += gsl_ran_binomial(r, p, (unsigned int)chunk);
+	return k + gsl_ran_binomial(r, p, (unsigned int)n);
+}
+
+// NegBin(k, p) is Poisson with a Gamma(k, (1 - p)/p) mean, the Poisson drawn in pieces of mean at most 1e9
+static long int negativeBinomial(gsl_rng* r, double p, long int k){
+	double mean = gsl_ran_gamma(r, (double)k, 1.0) * (1 - p) / p;
+	long int n = 0;
+	for(; mean > 1e9; mean -= 1e9)
+		n += gsl_ran_poisson(r, 1e9);
+	return n + gsl_ran_poisson(r, mean);
+}
+
+BirthDeath::BirthDeath(std::vector<double> b, std::vector<double> l, std::vector<double> m) : breaks(b), birth(l), death(m){}
+
+BirthDeath::~BirthDeath(){}
+
+long int BirthDeath::samplePiece(long int n, double lambda, double mu, double t, gsl_rng* r, double& extinct) const{
+	if(n == 0 || t <= 0 || (lambda == 0 && mu == 0))
+		return n;
+
+	// alpha = P(N(t) = 0), beta the ratio of the geometric tail, both from a single ancestor
+	double alpha, beta;
+	double rho = lambda - mu;
+	if(rho == 0){
+		alpha = lambda * t / (1 + lambda * t);
+		beta = alpha;
+	} else {
+		double e = expm1(rho * t);
+		alpha = mu * e / (lambda * e + rho);
+		beta = lambda * e / (lambda * e + rho);
+	}
+
+	long int k = alpha > 0 ? binomial(r, 1 - alpha, n) : n;
+	if(k == 0){
+		// Extinction time: the largest of n extinction times, each with distribution function alpha(s), given that
+		// all are before t, so alpha(s) = alpha(t) u^(1/n)
+		double a = alpha * pow(gsl_rng_uniform_pos(r), 1.0 / n);
+		extinct = rho == 0 ? a / (lambda * (1 - a)) : log1p(a * rho / (mu - a * lambda)) / rho;
+		return 0;
+	}
+	return beta > 0 ? k + negativeBinomial(r, 1 - beta, k) : k;
+}
+
+long int BirthDeath::sample(long int n, double start, double end, gsl_rng* r, double& extinct) const{
+	extinct = -1;
+	size_t p = std::upper_bound(breaks.begin(), breaks.end(), start) - breaks.begin() - 1;
+	double t = start;
+	while(t < end && n > 0){
+		double next = p + 1 < breaks.size() ? std::min(breaks[p + 1], end) : end;
+		double ext;
+		n = samplePiece(n, birth[p], death[p], next - t, r, ext);
+		if(n == 0)
+			extinct = t + ext;
+		t = next;
+		p++;
+	}
+	return n;
+}
+
+// Rows are written as System::simulate writes them: the state at each observation time, and a last row at the time of
+// extinction if the population dies out
+void BirthDeath::simulate(long int init, std::vector<double> obsTimes, int reps, std::string file, gsl_rng* r) const{
+	std::ofstream of;
+	of.open(file, std::fstream::in | std::fstream::out | std::fstream::app);
+	for(int rep = 1; rep <= reps; rep++){
+		long int n = init;
+		double t = 0;
+		for(size_t o = 0; o < obsTimes.size(); o++){
+			double extinct;
+			n = sample(n, t, obsTimes[o], r, extinct);
+			t = obsTimes[o];
+			if(extinct >= 0){
+				of << rep << "," << extinct << "," << 0 << std::endl;
+				break;
+			}
+			of << rep << "," << obsTimes[o] << "," << n << std::endl;
+		}
+		if(rep % 1000 == 0)
+			Rcpp::checkUserInterrupt();
+	}
+	if(!silent) std::cout << "Sampled " << reps << " replicates at " << obsTimes.size() << " observation times" << std::endl;
+}
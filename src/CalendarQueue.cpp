@@ -0,0 +1,86 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  CalendarQueue.cpp
+ *
+ *    Description:  Bucketed event queue for per-individual scheduled events
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 15:02:44
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "CalendarQueue.h"
+
+#include <algorithm>
+
+static bool later(const CalendarQueue::Event& a, const CalendarQueue::Event& b){
+	return a.offset > b.offset;
+}
+
+CalendarQueue::CalendarQueue(double s, double e, size_t nbuckets) : start(s), end(e), buckets(std::min((size_t)maxBuckets, std::max((size_t)1, nbuckets))){
+	width = (end - start) / buckets.size();
+	if(width <= 0)
+		width = 1;
+	clear();
+}
+
+CalendarQueue::~CalendarQueue(){}
+
+void CalendarQueue::clear(){
+	for(size_t b = 0; b < buckets.size(); b++){
+		std::vector<Event>().swap(buckets[b]);
+	}
+	current = 0;
+	count = 0;
+	last = start;
+}
+
+bool CalendarQueue::push(double time, unsigned int type){
+	if(time > end)
+		return false;
+
+	size_t b = (size_t)std::max(0.0, (time - start) / width);
+	b = std::min(std::max(b, current), buckets.size() - 1);
+
+	Event ev = {(float)(time - (start + b * width)), type};
+	buckets[b].push_back(ev);
+	if(b == current)
+		std::push_heap(buckets[b].begin(), buckets[b].end(), later);
+	count++;
+	return true;
+}
+
+bool CalendarQueue::pop(double& time, unsigned int& type){
+	if(count == 0)
+		return false;
+
+	// Advance to the next occupied bucket, releasing the memory of the drained one
+	while(buckets[current].empty()){
+		std::vector<Event>().swap(buckets[current]);
+		current++;
+		std::make_heap(buckets[current].begin(), buckets[current].end(), later);
+	}
+
+	std::vector<Event>& bucket = buckets[current];
+	std::pop_heap(bucket.begin(), bucket.end(), later);
+	Event ev = bucket.back();
+	bucket.pop_back();
+	count--;
+
+	// Offsets are single precision, so never step backward past the previous event
+	time = std::max(last, start + current * width + ev.offset);
+	type = ev.type;
+	last = time;
+	return true;
+}
+
+size_t CalendarQueue::size(){
+	return count;
+}
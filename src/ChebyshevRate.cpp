@@ -0,0 +1,154 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  ChebyshevRate.cpp
+ *
+ *    Description:  Piecewise Chebyshev surrogates for time-dependent rates
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 15:12:40
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+
+#include "ChebyshevRate.h"
+#include "ConstantRate.h"
+
+#include <algorithm>
+#include <cmath>
+
+extern bool silent;
+
+// Power series of degree ChebyshevRate::degree (8) at u in [-1, 1], by Estrin's scheme to keep the dependency chain short
+static inline double estrin(const double* a, double u){
+	double u2 = u*u;
+	double u4 = u2*u2;
+	double q0 = (a[0] + a[1]*u) + (a[2] + a[3]*u)*u2;
+	double q1 = (a[4] + a[5]*u) + (a[6] + a[7]*u)*u2;
+	return q0 + (q1 + a[8]*u4)*u4;
+}
+
+double chebyshevRate(double x, void* p){
+	return (*reinterpret_cast<ChebyshevRate*>(p))(x);
+}
+
+ChebyshevRate::ChebyshevRate(Rate& source, double start_time, double end_time, double tol){
+	start = start_time;
+	funct.function = &chebyshevRate;
+	funct.params = reinterpret_cast<void *>(this);
+
+	double span = std::max(end_time - start_time, 1e-12);
+	int pieces = 1;
+	while(true){
+		width = span / pieces;
+		fit(source, pieces);
+		if(error <= tol || pieces >= maxPieces)
+			break;
+		pieces *= 2;
+	}
+	rate_homog = *std::max_element(upper.begin(), upper.end());
+}
+
+ChebyshevRate::~ChebyshevRate(){}
+
+void ChebyshevRate::fit(Rate& source, int pieces){
+	const int n = degree + 1;
+	npieces = pieces;
+	invWidth = 1 / width;
+	coefs.assign(pieces * n, 0.0);
+	upper.assign(pieces, 0.0);
+	error = 0;
+
+	std::vector<double> values(n), c(n), tk(n), tkm(n);
+	for(int p = 0; p < pieces; ++p){
+		double lo = start + p*width;
+		for(int j = 0; j < n; ++j)
+			values[j] = source(lo + width*(1 + cos(M_PI*(j + .5)/n))/2);
+
+		for(int k = 0; k < n; ++k){
+			double s = 0;
+			for(int j = 0; j < n; ++j)
+				s += values[j]*cos(M_PI*k*(j + .5)/n);
+			c[k] = 2*s/n;
+		}
+		c[0] /= 2;
+
+		// Expand in powers of u, with T_{k+1} = 2u T_k - T_{k-1}
+		double* a = &coefs[p*n];
+		std::fill(tk.begin(), tk.end(), 0.0);
+		std::fill(tkm.begin(), tkm.end(), 0.0);
+		tkm[0] = 1;
+		tk[1] = 1;
+		a[0] = c[0];
+		for(int k = 1; k < n; ++k){
+			for(int j = 0; j < n; ++j)
+				a[j] += c[k]*tk[j];
+			for(int j = n - 1; j >= 0; --j){
+				double next = (j > 0 ? 2*tk[j - 1] : 0) - tkm[j];
+				tkm[j] = tk[j];
+				tk[j] = next;
+			}
+		}
+
+		// Error estimate: the error at the ends and between the nodes, or the size of the last two coefficients if larger,
+		// doubled. Only samples of the rate are seen, so this is not a bound for rates that vary between the samples
+		double err = fabs(c[degree]) + fabs(c[degree - 1]);
+		for(int j = 0; j <= 2*degree; ++j){
+			double u = (double)j/degree - 1;
+			err = std::max(err, fabs(source(lo + width*(u + 1)/2) - estrin(a, u)));
+		}
+		err *= 2;
+
+		// |T_k| <= 1 on the piece, so this bounds the interpolant, which is what is simulated
+		double bound = c[0];
+		for(int k = 1; k < n; ++k)
+			bound += fabs(c[k]);
+		upper[p] = bound + err;
+		error = std::max(error, err);
+	}
+}
+
+double ChebyshevRate::operator()(double time){
+	double x = (time - start)*invWidth;
+	int p = std::min(npieces - 1, std::max(0, (int)x));
+	return std::max(0.0, estrin(&coefs[p*(degree + 1)], 2*(x - p) - 1));
+}
+
+// The piece bounds hold for the interpolant itself, so no buffer is added
+void ChebyshevRate::fillMajorant(double start_time, double end_time, int bins, std::vector<double>& maxes, double /* buffer */){
+	std::vector<double> rest(upper);
+	for(int p = npieces - 2; p >= 0; --p)
+		rest[p] = std::max(rest[p], rest[p + 1]);
+
+	double delta_t = (end_time - start_time) / bins;
+	for(int step = 0; step < bins; ++step){
+		double x = (start_time + delta_t*step - start)*invWidth;
+		int p = std::min(npieces - 1, std::max(0, (int)x));
+		maxes[step] = std::max(0.0, rest[p]);
+	}
+}
+
+std::vector<double> useSurrogates(std::vector<Rate*>& rates, double start_time, double end_time, double tol){
+	std::vector<double> errors;
+	for(size_t i = 0; i < rates.size(); i++){
+		if(dynamic_cast<ConstantRate*>(rates[i]) || dynamic_cast<ChebyshevRate*>(rates[i]))
+			continue;
+
+		ChebyshevRate* r = new ChebyshevRate(*rates[i], start_time, end_time, tol);
+		if(!silent){
+			std::cout << "Rate " << i + 1 << " replaced by " << r->npieces << " Chebyshev pieces, error estimate " << r->error << std::endl;
+			if(r->error > tol)
+				std::cout << "Surrogate tolerance not reached for rate " << i + 1 << std::endl;
+		}
+		errors.push_back(r->error);
+		delete rates[i];
+		rates[i] = r;
+	}
+	return errors;
+}
@@ -0,0 +1,139 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Checkpoint.cpp
+ *
+ *    Description:  Binary snapshots of a replicate loop, for resuming long simulations
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 13:40:55
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "Checkpoint.h"
+
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <stdint.h>
+#include <algorithm>
+
+Checkpoint::Checkpoint() : rep(1), time(0), obs(0), offset(0) {}
+
+void Checkpoint::saveRng(const gsl_rng* r){
+	rngName = gsl_rng_name(r);
+	const char* s = (const char*)gsl_rng_state(r);
+	rngState.assign(s, s + gsl_rng_size(r));
+}
+
+void Checkpoint::restoreRng(gsl_rng* r) const{
+	if(rngName != gsl_rng_name(r) || rngState.size() != gsl_rng_size(r))
+		throw std::invalid_argument("Checkpoint was written with a different random number generator");
+	std::memcpy(gsl_rng_state(r), rngState.data(), rngState.size());
+}
+
+template <typename T>
+static void put(std::ostream& out, T x){
+	out.write((const char*)&x, sizeof(x));
+}
+
+template <typename T>
+static T get(std::istream& in){
+	T x;
+	in.read((char*)&x, sizeof(x));
+	if(!in)
+		throw std::runtime_error("Checkpoint file is truncated");
+	return x;
+}
+
+void Checkpoint::write(const std::string& file) const{
+	std::string tmp = file + ".tmp";
+	{
+		std::ofstream out(tmp, std::ios::out | std::ios::trunc | std::ios::binary);
+		if(!out.is_open())
+			throw std::runtime_error("Unable to write checkpoint " + tmp);
+		out.write("ESTICKP1", 8);
+		put<int32_t>(out, rep);
+		put<double>(out, time);
+		put<int32_t>(out, obs);
+		put<uint32_t>(out, state.size());
+		for(size_t i = 0; i < state.size(); i++)
+			put<int64_t>(out, state[i]);
+		put<uint32_t>(out, rngName.size());
+		out.write(rngName.data(), rngName.size());
+		put<uint32_t>(out, rngState.size());
+		out.write(rngState.data(), rngState.size());
+		put<int64_t>(out, offset);
+		put<uint32_t>(out, extra.size());
+		for(size_t i = 0; i < extra.size(); i++)
+			put<double>(out, extra[i]);
+		if(!out)
+			throw std::runtime_error("Unable to write checkpoint " + tmp);
+	}
+	std::remove(file.c_str());
+	if(std::rename(tmp.c_str(), file.c_str()) != 0)
+		throw std::runtime_error("Unable to rename " + tmp + " to " + file);
+}
+
+bool Checkpoint::read(const std::string& file){
+	std::ifstream in(file, std::ios::binary);
+	if(!in.is_open())
+		return false;
+	char magic[8];
+	in.read(magic, 8);
+	if(!in || std::memcmp(magic, "ESTICKP1", 8) != 0)
+		throw std::invalid_argument(file + " is not an estipop checkpoint");
+
+	rep = get<int32_t>(in);
+	time = get<double>(in);
+	obs = get<int32_t>(in);
+	state.resize(get<uint32_t>(in));
+	for(size_t i = 0; i < state.size(); i++)
+		state[i] = get<int64_t>(in);
+	rngName.resize(get<uint32_t>(in));
+	in.read(&rngName[0], rngName.size());
+	rngState.resize(get<uint32_t>(in));
+	in.read(rngState.data(), rngState.size());
+	offset = get<int64_t>(in);
+	extra.resize(get<uint32_t>(in));
+	for(size_t i = 0; i < extra.size(); i++)
+		extra[i] = get<double>(in);
+	return true;
+}
+
+long long fileSize(const std::string& file){
+	std::ifstream in(file, std::ios::binary | std::ios::ate);
+	return in.is_open() ? (long long)in.tellg() : 0;
+}
+
+void truncateFile(const std::string& file, long long size){
+	if(fileSize(file) == size)
+		return;
+	if(fileSize(file) < size)
+		throw std::runtime_error(file + " is shorter than its checkpoint says");
+
+	// Portable truncation: copy the kept prefix and rename it over the file
+	std::string tmp = file + ".tmp";
+	{
+		std::ifstream in(file, std::ios::binary);
+		std::ofstream out(tmp, std::ios::out | std::ios::trunc | std::ios::binary);
+		std::vector<char> buf(1 << 16);
+		long long left = size;
+		while(left > 0){
+			std::streamsize n = std::min<long long>(left, buf.size());
+			in.read(buf.data(), n);
+			out.write(buf.data(), n);
+			left -= n;
+		}
+	}
+	std::remove(file.c_str());
+	if(std::rename(tmp.c_str(), file.c_str()) != 0)
+		throw std::runtime_error("Unable to rename " + tmp + " to " + file);
+}
@@ -22,6 +22,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <cmath>
 #include <gsl/gsl_randist.h>
 
 extern gsl_rng* rng;
@@ -99,4 +100,36 @@ double SwitchRate::operator()(double time){
 		return params.pre;
 	else
 		return params.post;
-}
\ No newline at end of file
+}
+
+// PulseRate
+
+double pulseRate(double x, void* p){
+	pulse_params &params= *reinterpret_cast<pulse_params *>(p);
+	if(x - params.totPeriod * floor(x / params.totPeriod) < params.lowPeriod)
+		return params.low;
+	else
+		return params.high;
+}
+
+PulseRate::PulseRate(double totPeriod, double lowPeriod, double low, double high){
+	params.totPeriod = totPeriod;
+	params.lowPeriod = lowPeriod;
+	params.low = low;
+	params.high = high;
+
+	funct.function = &pulseRate;
+	funct.params = reinterpret_cast<void *>(&params);
+
+	rate_homog = std::max(low, high);
+}
+
+PulseRate::~PulseRate() {}
+
+double PulseRate::operator()(double time){
+	return pulseRate(time, &params);
+}
+
+double PulseRate::period(){
+	return params.totPeriod;
+}
@@ -16,22 +16,27 @@
 * =====================================================================================
 */
 
-// For plugin system
-#ifndef USE_PRECOMPILED_HEADERS
-#ifdef _WIN32
-#include <direct.h>
-#include <windows.h>
-#else
-#include <dlfcn.h>
-#endif
-#endif
-
 // Classes
 #include "System.h"
 #include "Update.h"
 #include "StopCriterion.h"
 #include "Rate.h"
 #include "ConstantRate.h"
+#include "SparseSystem.h"
+#include "ChebyshevRate.h"
+#include "Splitting.h"
+#include "MLMC.h"
+#include "Langevin.h"
+#include "Lockstep.h"
+#include "Abc.h"
+#include "ParticleFilter.h"
+#include "Sensitivity.h"
+#include "Superposition.h"
+#include "BirthDeath.h"
+#include "ModelLoader.h"
+#include "FileInput.h"
+#include "Checkpoint.h"
+#include "Stats.h"
 
 // Includes
 #include <iostream>
@@ -66,168 +71,203 @@ bool silent = false;
 
 
 
-// Helper Methods to read in data from text files
-template
-< typename T
-, template<typename ELEM, typename ALLOC=std::allocator<ELEM> > class Container
->
-std::ostream& operator<< (std::ostream& o, const Container<T>& container)
-{
-	typename Container<T>::const_iterator beg = container.begin();
+// Turn on checkpoints for sys and, when resuming from an existing one, drop the output written after it and restore the
+// replicate it was taken in. Returns the index of the first replicate left to simulate.
+static int startFromCheckpoint(System& sys, std::string file, std::string checkpoint, double every, bool resume){
+	if(checkpoint.empty())
+		return 0;
+	sys.enableCheckpoints(checkpoint, every);
+	Checkpoint c;
+	if(!resume || !c.read(checkpoint))
+		return 0;
+	if(!silent) std::cout << "Resuming replicate " << c.rep << " at time " << c.time << "..." << std::endl;
+	truncateFile(file, c.offset);
+	sys.resumeFrom(c);
+	return c.rep - 1;
+}
 
-	o << "["; // 1
+// Counters of a run as an R list, empty unless the package is compiled with ESTIPOP_STATS
+static Rcpp::List statsList(const System& sys){
+#ifdef ESTIPOP_STATS
+	const SimulationStats& s = sys.stats;
+	return Rcpp::List::create(
+		Rcpp::Named("replicates") = (double)s.replicates,
+		Rcpp::Named("stopped") = (double)s.stopped,
+		Rcpp::Named("extinct") = (double)s.extinct,
+		Rcpp::Named("events") = std::vector<double>(s.events.begin(), s.events.end()),
+		Rcpp::Named("proposals") = (double)s.proposals,
+		Rcpp::Named("accepts") = (double)s.accepts,
+		Rcpp::Named("stop_checks") = (double)s.stopChecks,
+		Rcpp::Named("majorant_builds") = (double)s.majorantBuilds,
+		Rcpp::Named("majorant_seconds") = s.majorantSeconds,
+		Rcpp::Named("rows") = (double)s.rows,
+		Rcpp::Named("output_bytes") = (double)s.outputBytes,
+		Rcpp::Named("output_seconds") = s.outputSeconds,
+		Rcpp::Named("simulate_seconds") = s.simulateSeconds);
+#else
+	return Rcpp::List();
+#endif
+}
 
-	while(beg != container.end())
-	{
-		o << " " << *beg++; // 2
+//' gmbp3
+//'
+//' gmbp3
+//'
+//' @export
+// [[Rcpp::export]]
+Rcpp::List gmbp3(Rcpp::NumericVector observations, int reps, std::string file, Rcpp::NumericVector initial, Rcpp::List transitions, Rcpp::List stops, bool silence, SEXP seed = R_NilValue, std::string checkpoint = "", double checkpoint_every = 600, bool resume = false){
+	double seedcpp;
+	if(Rf_isNull(seed)){
+		seedcpp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+	} else {
+		seedcpp = Rf_asReal(seed);
 	}
+    gsl_rng_set(rng, seedcpp);
+	silent = silence;
+
+	if(!silent) std::cout << "Starting process... " << std::endl;
+	if(!silent) std::cout << "Initialization system..." << std::endl;
+	// Initial population sizes
+	std::vector<long int> init(initial.begin(), initial.end());
 
-	o << " ]"; // 3
+	// Initialize system
+	System sys(init);
 
-	return o;
-}
+	/*
+	// Create populations with lifetimes
+	std::cout << "Making populations..." << std::endl;
+	for(size_t i = 0; i < init.size(); i++){
+	std::cout << "init[" << i << "]: " << init[i] << std::endl;
+	Population* p = new Population(lifetimes[i]);
+	sys.addPopulation(p);
+	}
+	*/
 
-// trim from left
-static inline std::string &ltrim(std::string &s)
-{
-	s.erase(s.begin(), std::find_if(s.begin(), s.end(),
-			std::not1(std::ptr_fun<int, int>(std::isspace))));
-	return s;
-}
+	// Add transitions
+	if(!silent) std::cout << "Adding transitions..." << std::endl;
 
-// trim from end
-static inline std::string &rtrim(std::string &s)
-{
-	s.erase(std::find_if(s.rbegin(), s.rend(),
-			std::not1(std::ptr_fun<int, int>(std::isspace))).base(), s.end());
-	return s;
-}
+	loadConstantTransitions(sys, transitions);
 
-// trim from both ends
-static inline std::string &trim(std::string &s)
-{
-	return ltrim(rtrim(s));
-}
+	// Add transitions
+	if(!silent) std::cout << "Adding stopping criteria..." << std::endl;
+	loadStops(sys, stops);
 
+	//sys.print();
 
-// Read in a vector matrix
-std::vector<std::vector<double> > fileToVectorMatrix(std::string name)
-{
-	std::vector<std::vector<double> > result;
-	std::ifstream input (name);
-	std::string lineData;
+	// Observation times
+	std::vector<double> obsTimes(observations.begin(), observations.end());
 
-	while(getline(input, lineData))
+	// Simulate
+	if(!silent) std::cout << "Simulating..." << std::endl;
+	try{
+	  int first = startFromCheckpoint(sys, file, checkpoint, checkpoint_every, resume);
+	  for(int i = first; i < reps; ++i){
+	  	sys.simulate(obsTimes, file);
+		sys.reset(init);
+		sys.nextRep();
+	  }
+	  if(!checkpoint.empty())
+		std::remove(checkpoint.c_str());
+	}
+	catch (Rcpp::internal::InterruptedException& e)
 	{
-		double d;
-		std::vector<double> row;
-		std::stringstream lineStream(lineData);
+	  std::cout << "interrupted!" << std::endl;
+	}	if(!silent) std::cout << "Ending process..." << std::endl;
+
+	return statsList(sys);
+}
 
-		while (lineStream >> d)
-		row.push_back(d);
 
-		result.push_back(row);
+//' timeDepBranch
+//'
+//' timeDepBranch
+//'
+//' @export
+// [[Rcpp::export]]
+Rcpp::List timeDepBranch(Rcpp::NumericVector observations, int reps, std::string file, Rcpp::NumericVector initial, Rcpp::List transitions, Rcpp::List stops, bool silence, SEXP seed = R_NilValue, double surrogate = 0, std::string checkpoint = "", double checkpoint_every = 600, bool resume = false){
+
+	double seedcpp;
+	if(Rf_isNull(seed)){
+		seedcpp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+	} else {
+		seedcpp = Rf_asReal(seed);
 	}
+    gsl_rng_set(rng, seedcpp);
+	silent = silence;
 
-	return result;
-}
 
-template <typename T>
-std::vector<T> flatten(const std::vector<std::vector<T> >& v)
-{
-	std::size_t total_size = 0;
-	for (const auto& sub : v)
-	total_size += sub.size(); // I wish there was a transform_accumulate
-	std::vector<T> result;
-	result.reserve(total_size);
-	for (const auto& sub : v)
-	result.insert(result.end(), sub.begin(), sub.end());
-	return result;
-}
+	PluginHandles plugins;
 
-// Read in a vector
-std::vector<double> fileToVector(std::string name)
-{
-	std::vector<std::vector<double> > result;
-	std::ifstream input (name);
-	std::string lineData;
+	if(!silent) std::cout << "Starting process... " << std::endl;
+	if(!silent) std::cout << "Initialization system..." << std::endl;
+	// Initial population sizes
+	std::vector<long int> init(initial.begin(), initial.end());
 
-	while(getline(input, lineData))
-	{
-		double d;
-		std::vector<double> row;
-		std::stringstream lineStream(lineData);
+	// Initialize system
+	System sys(init);
 
-		while (lineStream >> d)
-		row.push_back(d);
+	// Add transitions
+	if(!silent) std::cout << "Adding transitions..." << std::endl;
 
-		result.push_back(row);
-	}
+	loadTransitions(sys, transitions, plugins);
 
-	return flatten(result);
-}
+	// Add StopCriteria
+	if(!silent) std::cout << "Adding stopping criteria..." << std::endl;
+	loadStops(sys, stops);
 
-// Read in a text file, output a vector of strings, one string per line, trimmed
-std::vector<std::string> inputStringVector(std::string in)
-{
-	std::string s;
-	std::vector<std::string> a;
-	std::ifstream infile(in);
-	if(infile.is_open())
-	{
-		while(getline(infile, s))
-		{
-			// allow comments
-			std::string::iterator end_pos = std::remove(s.begin(), s.end(), ' ');
-			s.erase(end_pos, s.end());
-			a.push_back(trim(s));
-		}
-	}
+	//sys.print();
 
-	return(a);
-}
+	// Observation times
+	std::vector<double> obsTimes(observations.begin(), observations.end());
 
-std::vector<std::vector<std::string>> funct(std::string filename){
-	std::ifstream csv(filename);
-	std::string line;
-	std::vector <std::vector<std::string>> items;
-
-	if (csv.is_open()) {
-		for (std::string row_line; std::getline(csv, row_line);)
-		{
-			items.emplace_back();
-			std::istringstream row_stream(row_line);
-			for(std::string column; std::getline(row_stream, column, ',');)
-			items.back().push_back(column);
-		}
+	// Replace plugin rates with interpolants on the simulation horizon
+	std::vector<double> surrogateErrors;
+	if(surrogate > 0){
+		if(!silent) std::cout << "Building rate surrogates..." << std::endl;
+		surrogateErrors = useSurrogates(sys.rates2, 0, obsTimes[obsTimes.size()-1], surrogate);
 	}
-	else {
-		std::cout << "Unable to open file";
+
+	// Simulate
+	if(!silent) std::cout << "Simulating..." << std::endl;
+	try{
+	  int first = startFromCheckpoint(sys, file, checkpoint, checkpoint_every, resume);
+	  for(int i = first; i < reps; ++i){
+	  	sys.simulate_timedep(obsTimes, file);
+		sys.reset(init);
+		sys.nextRep();
+	  }
+	  if(!checkpoint.empty())
+		std::remove(checkpoint.c_str());
+	}
+	catch (Rcpp::internal::InterruptedException& e)
+	{
+	  std::cout << "interrupted!" << std::endl;
 	}
+	if(!silent) std::cout << "Ending process..." << std::endl;
 
-	return items;
+	Rcpp::List stats = statsList(sys);
+	if(surrogate > 0)
+		stats.push_back(Rcpp::wrap(surrogateErrors), "surrogate_errors");
+	return stats;
 }
 
-//' gmbp3
+//' ageDepBranch
 //'
-//' gmbp3
+//' ageDepBranch
 //'
 //' @export
 // [[Rcpp::export]]
-double gmbp3(Rcpp::NumericVector observations, int reps, std::string file, Rcpp::NumericVector initial, Rcpp::List transitions, Rcpp::List stops, bool silence, SEXP seed = R_NilValue){
+double ageDepBranch(Rcpp::NumericVector observations, int reps, std::string file, Rcpp::NumericVector initial, Rcpp::List transitions, Rcpp::List lifetimes, Rcpp::List stops, bool silence, SEXP seed = R_NilValue){
 	double seedcpp;
 	if(Rf_isNull(seed)){
 		seedcpp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
 	} else {
 		seedcpp = Rf_asReal(seed);
 	}
-    gsl_rng_set(rng, seedcpp);
+	gsl_rng_set(rng, seedcpp);
 	silent = silence;
 
 	if(!silent) std::cout << "Starting process... " << std::endl;
-	int nTrans = transitions.length();
-	int nStops = stops.length();
-
 	if(!silent) std::cout << "Initialization system..." << std::endl;
 	// Initial population sizes
 	std::vector<long int> init(initial.begin(), initial.end());
@@ -235,232 +275,589 @@ double gmbp3(Rcpp::NumericVector observations, int reps, std::string file, Rcpp:
 	// Initialize system
 	System sys(init);
 
-	/*
-	// Create populations with lifetimes
-	std::cout << "Making populations..." << std::endl;
-	for(size_t i = 0; i < init.size(); i++){
-	std::cout << "init[" << i << "]: " << init[i] << std::endl;
-	Population* p = new Population(lifetimes[i]);
-	sys.addPopulation(p);
-	}
-	*/
-
-	// Add transitions
+	// Add transitions, whose rates give the offspring probabilities at the end of a lifetime
 	if(!silent) std::cout << "Adding transitions..." << std::endl;
+	loadConstantTransitions(sys, transitions);
 
-	// Iterate over transitions list
-	for(int i = 0; i < nTrans; i++){
-
-		// Get the ith transition
-		Rcpp::List list_i = Rcpp::as<Rcpp::List>(transitions[i]);
-
-		// Get popuation, is_random, probability
-		int population = list_i["parent"];
-		population -= 1; //switch to 0-index
-		double rate = list_i["rate"];
-
-		// Get the fixed portion of the Transition
-		Rcpp::NumericVector fix = Rcpp::as<Rcpp::NumericVector>(list_i["offspring"]);
-		std::vector<int> fixed (fix.begin(), fix.end());
+	if(!silent) std::cout << "Adding lifetimes..." << std::endl;
+	loadLifetimes(sys, lifetimes);
 
-		// add update
-		sys.addUpdate(rate, population, Update(fixed));
-	}
-
-	// Add transitions
+	// Add StopCriteria
 	if(!silent) std::cout << "Adding stopping criteria..." << std::endl;
+	loadStops(sys, stops);
 
-	// Iterate over transitions list
-	for(int i = 0; i < nStops; i++){
+	// Observation times
+	std::vector<double> obsTimes(observations.begin(), observations.end());
 
-		// Get the ith transition
-		Rcpp::List list_i = Rcpp::as<Rcpp::List>(stops[i]);
+	// Simulate
+	if(!silent) std::cout << "Simulating..." << std::endl;
+	try{
+	  for(int i =0; i < reps; ++i){
+	  	sys.simulate_age(obsTimes, file);
+		sys.reset(init);
+		sys.nextRep();
+	  }
+	}
+	catch (Rcpp::internal::InterruptedException& e)
+	{
+	  std::cout << "interrupted!" << std::endl;
+	}
+	if(!silent) std::cout << "Ending process..." << std::endl;
 
-		// Get popuation, is_random, probability
+	return 0.0;
+}
 
-		// Get the offspring distribution of the Transition
-		Rcpp::NumericVector ind = Rcpp::as<Rcpp::NumericVector>(list_i[0]);
-		std::vector<int> indices (ind.begin(), ind.end());
+//' sparseBranch
+//'
+//' sparseBranch
+//'
+//' @export
+// [[Rcpp::export]]
+Rcpp::List sparseBranch(Rcpp::NumericVector observations, int reps, std::string file, Rcpp::NumericVector initial_ids, Rcpp::NumericVector initial_counts, Rcpp::List rules, bool silence, SEXP seed = R_NilValue, bool lineage = false){
+	double seedcpp;
+	if(Rf_isNull(seed)){
+		seedcpp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+	} else {
+		seedcpp = Rf_asReal(seed);
+	}
+	gsl_rng_set(rng, seedcpp);
+	silent = silence;
 
-		std::string ineq = list_i[1];
-		double value = list_i[2];
+	if(!silent) std::cout << "Starting process... " << std::endl;
+	if(!silent) std::cout << "Initialization system..." << std::endl;
+	std::vector<long long> ids(initial_ids.begin(), initial_ids.end());
+	std::vector<long int> counts(initial_counts.begin(), initial_counts.end());
 
-		sys.addStop(StopCriterion(indices, ineq, value));
-	}
+	SparseSystem sys;
+	sys.recordLineage = lineage;
+	sys.reset(ids, counts);
 
-	//sys.print();
+	if(!silent) std::cout << "Adding rules..." << std::endl;
+	loadSparseRules(sys, rules);
 
 	// Observation times
 	std::vector<double> obsTimes(observations.begin(), observations.end());
 
+	// Genealogy of each replicate as parallel arrays
+	Rcpp::List trees;
+
 	// Simulate
 	if(!silent) std::cout << "Simulating..." << std::endl;
 	try{
 	  for(int i =0; i < reps; ++i){
 	  	sys.simulate(obsTimes, file);
-		sys.reset(init);
+		if(lineage){
+			std::vector<long long> id;
+			std::vector<int> parent, rule;
+			std::vector<double> time;
+			sys.lineage.collect(id, parent, time, rule);
+			trees.push_back(Rcpp::List::create(Rcpp::Named("type_id") = Rcpp::NumericVector(id.begin(), id.end()),
+			                                   Rcpp::Named("parent") = Rcpp::wrap(parent),
+			                                   Rcpp::Named("time") = Rcpp::wrap(time),
+			                                   Rcpp::Named("rule") = Rcpp::wrap(rule)));
+		}
+		sys.reset(ids, counts);
 		sys.nextRep();
 	  }
 	}
 	catch (Rcpp::internal::InterruptedException& e)
 	{
 	  std::cout << "interrupted!" << std::endl;
-	}	if(!silent) std::cout << "Ending process..." << std::endl;
+	}
+	if(!silent) std::cout << "Ending process..." << std::endl;
 
-	return 0.0;
+	return trees;
 }
 
-
-//' timeDepBranch
+//' splitBranch
 //'
-//' timeDepBranch
+//' splitBranch
 //'
 //' @export
 // [[Rcpp::export]]
-double timeDepBranch(Rcpp::NumericVector observations, int reps, std::string file, Rcpp::NumericVector initial, Rcpp::List transitions, Rcpp::List stops, bool silence, SEXP seed = R_NilValue){
+Rcpp::List splitBranch(Rcpp::NumericVector initial, Rcpp::List transitions, Rcpp::List target, Rcpp::NumericVector levels, double horizon, int effort, double budget, int max_reps, bool silence, SEXP seed = R_NilValue){
+	double seedcpp;
+	if(Rf_isNull(seed)){
+		seedcpp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+	} else {
+		seedcpp = Rf_asReal(seed);
+	}
+	gsl_rng_set(rng, seedcpp);
+	silent = silence;
+
+	std::vector<long int> init(initial.begin(), initial.end());
+	System sys(init);
+	loadConstantTransitions(sys, transitions);
+
+	// The target uses the stopping criterion form; its sum is also the importance function
+	SplitResult res = multilevelSplitting(sys, init, loadStop(target), std::vector<double>(levels.begin(), levels.end()),
+	                                      horizon, effort, budget, max_reps);
+
+	return Rcpp::List::create(Rcpp::Named("estimate") = res.estimate,
+	                          Rcpp::Named("variance") = res.variance,
+	                          Rcpp::Named("replications") = res.replications,
+	                          Rcpp::Named("level_probs") = Rcpp::wrap(res.levelProbs));
+}
 
+//' mlmcBranch
+//'
+//' mlmcBranch
+//'
+//' @export
+// [[Rcpp::export]]
+Rcpp::List mlmcBranch(Rcpp::NumericVector initial, Rcpp::List transitions, double horizon, Rcpp::NumericVector weights, bool extinct, double h0, int refine, int nlevels, double rmse, int pilot, bool silence, SEXP seed = R_NilValue){
 	double seedcpp;
 	if(Rf_isNull(seed)){
 		seedcpp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
 	} else {
 		seedcpp = Rf_asReal(seed);
 	}
-    gsl_rng_set(rng, seedcpp);
+	gsl_rng_set(rng, seedcpp);
 	silent = silence;
 
+	std::vector<long int> init(initial.begin(), initial.end());
+	System sys(init);
+	loadConstantTransitions(sys, transitions);
+
+	MLMC mlmc(sys, init, horizon, std::vector<double>(weights.begin(), weights.end()), extinct, h0, refine, nlevels);
+	mlmc.estimate(rmse, pilot);
+
+	// Per-level table; the estimate is the sum of the level means
+	int n = mlmc.stats.size();
+	Rcpp::NumericVector step(n), samples(n), mean(n), variance(n), cost(n);
+	double estimate = 0, error = 0;
+	for(int l = 0; l < n; l++){
+		const LevelStats& s = mlmc.stats[l];
+		step[l] = s.step;
+		samples[l] = s.samples;
+		mean[l] = s.mean();
+		variance[l] = s.variance();
+		cost[l] = s.cost();
+		estimate += s.mean();
+		error += s.variance() / s.samples;
+	}
+
+	return Rcpp::List::create(Rcpp::Named("estimate") = estimate,
+	                          Rcpp::Named("rmse") = std::sqrt(error),
+	                          Rcpp::Named("levels") = Rcpp::DataFrame::create(Rcpp::Named("step") = step,
+	                                                                           Rcpp::Named("samples") = samples,
+	                                                                           Rcpp::Named("mean") = mean,
+	                                                                           Rcpp::Named("variance") = variance,
+	                                                                           Rcpp::Named("cost") = cost));
+}
 
-	#ifdef _WIN32
-	HINSTANCE lib_handle;
-	#else
-	std::vector<void*> handles;
-	#endif
+//' langevinBranch
+//'
+//' langevinBranch
+//'
+//' @export
+// [[Rcpp::export]]
+double langevinBranch(Rcpp::NumericVector observations, int reps, std::string file, Rcpp::NumericVector initial, Rcpp::List transitions, Rcpp::List stops, double dt, int block, bool silence, SEXP seed = R_NilValue){
+	double seedcpp;
+	if(Rf_isNull(seed)){
+		seedcpp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+	} else {
+		seedcpp = Rf_asReal(seed);
+	}
+	gsl_rng_set(rng, seedcpp);
+	silent = silence;
 
+	PluginHandles plugins;
 
 	if(!silent) std::cout << "Starting process... " << std::endl;
-	int nTrans = transitions.length();
-	int nStops = stops.length();
-
-	if(!silent) std::cout << "Initialization system..." << std::endl;
-	// Initial population sizes
 	std::vector<long int> init(initial.begin(), initial.end());
+	System sys(init);
 
-	// Initialize system
+	// Constant and plugin rates both go through Rate objects, evaluated once per step for the whole block
+	if(!silent) std::cout << "Adding transitions..." << std::endl;
+	loadTransitions(sys, transitions, plugins);
+
+	if(!silent) std::cout << "Adding stopping criteria..." << std::endl;
+	loadStops(sys, stops);
+
+	std::vector<double> obsTimes(observations.begin(), observations.end());
+
+	if(!silent) std::cout << "Simulating..." << std::endl;
+	LangevinBlock lb(sys, block);
+	try{
+	  for(int i = 0; i < reps; i += block){
+	  	lb.simulate(obsTimes, file, i + 1, reps - i, dt);
+	  }
+	}
+	catch (Rcpp::internal::InterruptedException& e)
+	{
+	  std::cout << "interrupted!" << std::endl;
+	}
+	if(!silent) std::cout << "Ending process..." << std::endl;
+
+	return 0.0;
+}
+
+//' lockstepBranch
+//'
+//' lockstepBranch
+//'
+//' @export
+// [[Rcpp::export]]
+double lockstepBranch(Rcpp::NumericVector observations, int reps, std::string file, Rcpp::NumericVector initial, Rcpp::List transitions, Rcpp::List stops, int lanes, bool silence, SEXP seed = R_NilValue){
+	double seedcpp;
+	if(Rf_isNull(seed)){
+		seedcpp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+	} else {
+		seedcpp = Rf_asReal(seed);
+	}
+	gsl_rng_set(rng, seedcpp);
+	silent = silence;
+
+	if(!silent) std::cout << "Starting process... " << std::endl;
+	std::vector<long int> init(initial.begin(), initial.end());
 	System sys(init);
 
-	// Add transitions
 	if(!silent) std::cout << "Adding transitions..." << std::endl;
+	loadConstantTransitions(sys, transitions);
+
+	if(!silent) std::cout << "Adding stopping criteria..." << std::endl;
+	loadStops(sys, stops);
 
-	// Iterate over transitions list
-	for(int i = 0; i < nTrans; i++){
+	std::vector<double> obsTimes(observations.begin(), observations.end());
+
+	if(!silent) std::cout << "Simulating " << lanes << " replicates at a time..." << std::endl;
+	LockstepSSA ssa(sys, lanes);
+	try{
+		ssa.simulate(obsTimes, file, reps);
+	}
+	catch (Rcpp::internal::InterruptedException& e)
+	{
+	  std::cout << "interrupted!" << std::endl;
+	}
+	if(!silent) std::cout << "Ending process..." << std::endl;
 
-		// Get the ith transition
+	return 0.0;
+}
+
+//' abcSmc
+//'
+//' abcSmc
+//'
+//' @export
+// [[Rcpp::export]]
+Rcpp::List abcSmc(Rcpp::List transitions, int ntype, Rcpp::NumericMatrix init_pop, Rcpp::NumericMatrix final_pop, Rcpp::NumericVector durations, Rcpp::NumericVector lower, Rcpp::NumericVector upper, int particles, int generations, double quantile, double max_proposals, double max_events, int threads, bool silence, SEXP seed = R_NilValue){
+	double seedcpp;
+	if(Rf_isNull(seed)){
+		seedcpp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+	} else {
+		seedcpp = Rf_asReal(seed);
+	}
+	silent = silence;
+
+	std::vector<Expression> rates;
+	std::vector<int> from;
+	std::vector<std::vector<int> > offspring;
+	for(int i = 0; i < transitions.length(); i++){
 		Rcpp::List list_i = Rcpp::as<Rcpp::List>(transitions[i]);
+		rates.push_back(loadExpression(list_i));
+		from.push_back(loadParent(list_i));
+		offspring.push_back(loadOffspring(list_i));
+	}
 
-		// Get popuation, is_random, probability
-		int population = list_i["parent"];
-		population -= 1; //shift to 0-indexing
-		Rcpp::List rateList = Rcpp::as<Rcpp::List>(list_i["rate"]);
-		Rate* r = nullptr;
-		if(Rcpp::as<int>(list_i["type"]) == 1)
-		{
-			if(!silent) std::cout << "Constant rate found!" << std::endl;
-			r = new ConstantRate(Rcpp::as<double>(list_i["rate"]));
-
-		} 
-		else if(Rcpp::as<int>(list_i["type"]) == 2)
-		{
-			if(!silent) std::cout << "Variable rate found!" << std::endl;
-			Rcpp::StringVector params = Rcpp::as<Rcpp::StringVector>(list_i["rate"]);
-
-			double (*rate)(double, void*);
-
-			// Name for plugin library location
-			const char* plugin_location = CHAR(Rf_asChar(params[0]));
-			std::cout << params[0] << std::endl;
-			std::cout << params[1] << std::endl;
-			//Rcpp::Rcout << params[1] << std::endl;
-			// Load plugin library
-			#ifdef _WIN32
-				lib_handle = LoadLibrary(plugin_location);
-				if(!lib_handle)
-				{
-					Rcpp::stop("invalid file name for custom dll");
-				}
-			rate = (double (*)(double, void*))GetProcAddress(lib_handle, params[1]);
-			#else
-				void* hand = dlopen(plugin_location, RTLD_NOW);
-				handles.push_back(hand);
-				if(!hand)
-				{
-					Rcpp::stop("invalid file name custom dll");
-				}
-				rate = (double (*)(double, void*))dlsym(hand, params[1]);
-			#endif
-
-			r = new Rate(rate);
-
-		} else{
-				Rcpp::stop("invalid rate selection");
+	// Observations row by row
+	int nobs = init_pop.nrow();
+	std::vector<long int> init(nobs*ntype), fin(nobs*ntype);
+	for(int obs = 0; obs < nobs; obs++){
+		for(int i = 0; i < ntype; i++){
+			init[obs*ntype + i] = init_pop(obs, i);
+			fin[obs*ntype + i] = final_pop(obs, i);
 		}
+	}
 
+	AbcSMC abc(rates, from, offspring, ntype, init, fin, std::vector<double>(durations.begin(), durations.end()),
+	           std::vector<double>(lower.begin(), lower.end()), std::vector<double>(upper.begin(), upper.end()), (long int)max_events);
+	try{
+		abc.run(particles, generations, quantile, (long int)max_proposals, threads, (unsigned long int)seedcpp);
+	}
+	catch (Rcpp::internal::InterruptedException& e)
+	{
+	  std::cout << "interrupted!" << std::endl;
+	}
 
-		// Get the offspring vector of the transition
-		Rcpp::NumericVector fix = Rcpp::as<Rcpp::NumericVector>(list_i["offspring"]);
-		std::vector<int> fixed (fix.begin(), fix.end());
+	int n = abc.weights.size();
+	Rcpp::NumericMatrix params(n, abc.nparam);
+	for(int i = 0; i < n; i++)
+		for(int p = 0; p < abc.nparam; p++)
+			params(i, p) = abc.particles[i*abc.nparam + p];
+
+	int g = abc.history.size();
+	Rcpp::NumericVector generation(g), tolerance(g), proposals(g), accepted(g), acceptance(g), early(g), over_budget(g), ess(g), seconds(g);
+	for(int k = 0; k < g; k++){
+		const AbcGeneration& s = abc.history[k];
+		generation[k] = k + 1;
+		tolerance[k] = s.tolerance;
+		proposals[k] = s.proposals;
+		accepted[k] = s.accepted;
+		acceptance[k] = s.proposals > 0 ? (double)s.accepted/s.proposals : 0;
+		early[k] = s.early;
+		over_budget[k] = s.overBudget;
+		ess[k] = s.ess;
+		seconds[k] = s.seconds;
+	}
 
-		// add update
-		Update u = Update(fixed);
+	return Rcpp::List::create(Rcpp::Named("params") = params,
+	                          Rcpp::Named("weights") = Rcpp::wrap(abc.weights),
+	                          Rcpp::Named("distances") = Rcpp::wrap(abc.distances),
+	                          Rcpp::Named("complete") = abc.complete,
+	                          Rcpp::Named("generations") = Rcpp::DataFrame::create(Rcpp::Named("generation") = generation,
+	                                                                                Rcpp::Named("tolerance") = tolerance,
+	                                                                                Rcpp::Named("proposals") = proposals,
+	                                                                                Rcpp::Named("accepted") = accepted,
+	                                                                                Rcpp::Named("acceptance") = acceptance,
+	                                                                                Rcpp::Named("early") = early,
+	                                                                                Rcpp::Named("over_budget") = over_budget,
+	                                                                                Rcpp::Named("ess") = ess,
+	                                                                                Rcpp::Named("seconds") = seconds));
+}
 
-		sys.addUpdate(r, population, u);
+//' particleFilter
+//'
+//' particleFilter
+//'
+//' @export
+// [[Rcpp::export]]
+Rcpp::List particleFilter(Rcpp::NumericVector initial, Rcpp::List transitions, Rcpp::NumericVector times, Rcpp::NumericMatrix observed, Rcpp::List emissions, int particles, double ess_threshold, double leap_threshold, int threads, bool silence, SEXP seed = R_NilValue){
+	double seedcpp;
+	if(Rf_isNull(seed)){
+		seedcpp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+	} else {
+		seedcpp = Rf_asReal(seed);
 	}
+	silent = silence;
 
-	// Add StopCriteria
-	if(!silent) std::cout << "Adding stopping criteria..." << std::endl;
+	PluginHandles plugins;
 
-	// Iterate over StopCriterionList list
-	for(int i = 0; i < nStops; i++){
+	std::vector<long int> init(initial.begin(), initial.end());
+	System sys(init);
+	loadConstantTransitions(sys, transitions);
+
+	std::vector<Emission> emission;
+	for(int i = 0; i < emissions.length(); i++)
+		emission.push_back(loadEmission(Rcpp::as<Rcpp::List>(emissions[i]), plugins));
+
+	// Observations row by row, NA for unobserved types
+	int nobs = observed.nrow();
+	int ntype = init.size();
+	std::vector<double> obs(nobs*ntype);
+	for(int k = 0; k < nobs; k++)
+		for(int i = 0; i < ntype; i++)
+			obs[k*ntype + i] = observed(k, i);
+
+	ParticleFilter pf(sys, emission, leap_threshold);
+	double loglik = -std::numeric_limits<double>::infinity();
+	try{
+		loglik = pf.logLikelihood(init, std::vector<double>(times.begin(), times.end()), obs, particles, ess_threshold, threads, (unsigned long int)seedcpp);
+	}
+	catch (Rcpp::internal::InterruptedException& e)
+	{
+	  std::cout << "interrupted!" << std::endl;
+	}
 
-		// Get the ith SC
-		Rcpp::List list_i = Rcpp::as<Rcpp::List>(stops[i]);
+	int n = pf.ess.size();
+	return Rcpp::List::create(Rcpp::Named("loglik") = loglik,
+	                          Rcpp::Named("leaps") = (double)pf.leaps,
+	                          Rcpp::Named("steps") = Rcpp::DataFrame::create(Rcpp::Named("time") = Rcpp::NumericVector(times.begin(), times.begin() + n),
+	                                                                          Rcpp::Named("ess") = Rcpp::wrap(pf.ess),
+	                                                                          Rcpp::Named("increment") = Rcpp::wrap(pf.increments),
+	                                                                          Rcpp::Named("resampled") = Rcpp::wrap(pf.resampled)));
+}
 
-		// Get the indices to combine, inequality for comparison, and value to compare against
-		Rcpp::NumericVector ind = Rcpp::as<Rcpp::NumericVector>(list_i[0]);
-		std::vector<int> indices (ind.begin(), ind.end());
+//' sensitivityBranch
+//'
+//' sensitivityBranch
+//'
+//' @export
+// [[Rcpp::export]]
+Rcpp::List sensitivityBranch(Rcpp::NumericVector observations, int reps, Rcpp::NumericVector initial, Rcpp::List transitions, Rcpp::NumericMatrix perturbed, Rcpp::NumericMatrix jacobian, bool crn, bool lr, int threads, bool silence, SEXP seed = R_NilValue){
+	double seedcpp;
+	if(Rf_isNull(seed)){
+		seedcpp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+	} else {
+		seedcpp = Rf_asReal(seed);
+	}
+	silent = silence;
+
+	std::vector<long int> init(initial.begin(), initial.end());
+	System sys(init);
+	loadConstantTransitions(sys, transitions);
+
+	// Column j of perturbed and jacobian holds every transition's rate with parameter j stepped, and its derivative
+	int nparam = jacobian.ncol();
+	std::vector<std::vector<double> > p(nparam), jac(nparam);
+	for(int j = 0; j < nparam; j++){
+		p[j] = std::vector<double>(perturbed.column(j).begin(), perturbed.column(j).end());
+		jac[j] = std::vector<double>(jacobian.column(j).begin(), jacobian.column(j).end());
+	}
 
-		std::string ineq = list_i[1];
-		double value = list_i[2];
+	std::vector<double> obsTimes(observations.begin(), observations.end());
+	int nobs = obsTimes.size();
+	int ntype = init.size();
+	int width = nobs * ntype;
 
-		sys.addStop(StopCriterion(indices, ineq, value));
+	if(!silent) std::cout << "Simulating " << reps << " replicates on common streams..." << std::endl;
+	Sensitivity sens(sys, p, jac);
+	try{
+		sens.simulate(init, obsTimes, reps, crn, lr, threads, (unsigned long int)seedcpp);
+	}
+	catch (Rcpp::internal::InterruptedException& e)
+	{
+	  std::cout << "interrupted!" << std::endl;
 	}
 
-	//sys.print();
+	// Replicates in rows; column o*ntype + i is type i at observation o, column o*nparam + j the score of parameter j
+	Rcpp::NumericMatrix nominal(reps, width);
+	Rcpp::NumericMatrix shifted(reps, crn ? nparam * width : 0);
+	Rcpp::NumericMatrix score(reps, lr ? nobs * nparam : 0);
+	for(int rep = 0; rep < reps; rep++){
+		for(int c = 0; c < width; c++){
+			nominal(rep, c) = sens.nominal[(size_t)rep * width + c];
+			for(int j = 0; crn && j < nparam; j++)
+				shifted(rep, j * width + c) = sens.shifted[((size_t)j * reps + rep) * width + c];
+		}
+		for(int c = 0; lr && c < nobs * nparam; c++)
+			score(rep, c) = sens.scores[(size_t)rep * nobs * nparam + c];
+	}
 
-	// Observation times
-	std::vector<double> obsTimes(observations.begin(), observations.end());
+	return Rcpp::List::create(Rcpp::Named("nominal") = nominal,
+	                          Rcpp::Named("shifted") = shifted,
+	                          Rcpp::Named("score") = score,
+	                          Rcpp::Named("events") = (double)sens.events);
+}
 
-	// Simulate
-	if(!silent) std::cout << "Simulating..." << std::endl;
+//' superpositionLibrary
+//'
+//' superpositionLibrary
+//'
+//' @export
+// [[Rcpp::export]]
+Rcpp::List superpositionLibrary(Rcpp::NumericVector observations, int ntype, Rcpp::List transitions, int size, int threads, bool silence, SEXP seed = R_NilValue){
+	double seedcpp;
+	if(Rf_isNull(seed)){
+		seedcpp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+	} else {
+		seedcpp = Rf_asReal(seed);
+	}
+	silent = silence;
+
+	System sys(std::vector<long int>(ntype, 0));
+	loadConstantTransitions(sys, transitions);
+
+	std::vector<double> obsTimes(observations.begin(), observations.end());
+	Superposition sp(ntype, obsTimes.size());
 	try{
-	  for(int i =0; i < reps; ++i){
-	  	sys.simulate_timedep(obsTimes, file);
-		sys.reset(init);
-		sys.nextRep();
-	  }
+		sp.build(sys, obsTimes, size, threads, (unsigned long int)seedcpp);
 	}
 	catch (Rcpp::internal::InterruptedException& e)
 	{
 	  std::cout << "interrupted!" << std::endl;
 	}
-	if(!silent) std::cout << "Ending process..." << std::endl;
 
-	#ifdef _WIN32
-		FreeLibrary(lib_handle);
-	#else
-		for(auto i = handles.begin(); i != handles.end(); i++){
-			dlclose(*i);
-			std::cout << "closing" << std::endl;
+	// One size x width matrix per starting type; column o*ntype + i is type i at observation o
+	Rcpp::List library(ntype);
+	for(int i = 0; i < ntype; i++){
+		Rcpp::NumericMatrix lib(size, sp.width);
+		for(int l = 0; l < size; l++)
+			for(int c = 0; c < sp.width; c++)
+				lib(l, c) = sp.library[i][(size_t)l * sp.width + c];
+		library[i] = lib;
+	}
+	return library;
+}
+
+//' superposeBranch
+//'
+//' superposeBranch
+//'
+//' @export
+// [[Rcpp::export]]
+Rcpp::NumericMatrix superposeBranch(Rcpp::NumericVector observations, Rcpp::List library, Rcpp::NumericMatrix initial, int reps, double clt_threshold, bool silence, SEXP seed = R_NilValue){
+	double seedcpp;
+	if(Rf_isNull(seed)){
+		seedcpp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+	} else {
+		seedcpp = Rf_asReal(seed);
+	}
+	gsl_rng_set(rng, seedcpp);
+	silent = silence;
+
+	int ntype = library.length();
+	int nobs = observations.size();
+	Superposition sp(ntype, nobs);
+	for(int i = 0; i < ntype; i++){
+		Rcpp::NumericMatrix lib = Rcpp::as<Rcpp::NumericMatrix>(library[i]);
+		sp.library[i].resize((size_t)lib.nrow() * sp.width);
+		for(int l = 0; l < lib.nrow(); l++)
+			for(int c = 0; c < sp.width; c++)
+				sp.library[i][(size_t)l * sp.width + c] = lib(l, c);
+	}
+
+	// The covariance and its factor cost width^2 per library row, so they are only computed for types that some initial
+	// population has more than clt_threshold of
+	int npop = initial.nrow();
+	std::vector<bool> clt(ntype, false);
+	for(int p = 0; p < npop; p++)
+		for(int i = 0; i < ntype; i++)
+			clt[i] = clt[i] || initial(p, i) > clt_threshold;
+	sp.moments(clt);
+
+	// One row per initial population, replicate and observation time: pop, rep, time, then the types
+	Rcpp::NumericMatrix out(npop * reps * nobs, ntype + 3);
+	std::vector<double> row(sp.width);
+	int k = 0;
+	for(int p = 0; p < npop; p++){
+		Rcpp::NumericVector ip = initial.row(p);
+		std::vector<long int> init(ip.begin(), ip.end());
+		if(!silent) std::cout << "Assembling " << reps << " replicates of initial population " << p + 1 << "..." << std::endl;
+		for(int rep = 0; rep < reps; rep++){
+			sp.sample(init, clt_threshold, rng, row.data());
+			for(int o = 0; o < nobs; o++, k++){
+				out(k, 0) = p + 1;
+				out(k, 1) = rep + 1;
+				out(k, 2) = observations[o];
+				for(int i = 0; i < ntype; i++)
+					out(k, i + 3) = row[o * ntype + i];
+			}
+			if(rep % 1000 == 0)
+				Rcpp::checkUserInterrupt();
 		}
-	#endif
+	}
+	return out;
+}
+
+//' birthDeathBranch
+//'
+//' birthDeathBranch
+//'
+//' @export
+// [[Rcpp::export]]
+double birthDeathBranch(Rcpp::NumericVector observations, int reps, std::string file, double initial, Rcpp::NumericVector breaks, Rcpp::NumericVector birth, Rcpp::NumericVector death, bool silence, SEXP seed = R_NilValue){
+	double seedcpp;
+	if(Rf_isNull(seed)){
+		seedcpp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+	} else {
+		seedcpp = Rf_asReal(seed);
+	}
+	gsl_rng_set(rng, seedcpp);
+	silent = silence;
+
+	if(!silent) std::cout << "Sampling the exact birth-death transition law..." << std::endl;
+	BirthDeath bd(std::vector<double>(breaks.begin(), breaks.end()), std::vector<double>(birth.begin(), birth.end()),
+	              std::vector<double>(death.begin(), death.end()));
+	try{
+		bd.simulate((long int)initial, std::vector<double>(observations.begin(), observations.end()), reps, file, rng);
+	}
+	catch (Rcpp::internal::InterruptedException& e)
+	{
+	  std::cout << "interrupted!" << std::endl;
+	}
+	if(!silent) std::cout << "Ending process..." << std::endl;
 
 	return 0.0;
 }
+
@@ -0,0 +1,92 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Emission.cpp
+ *
+ *    Description:  Observation densities for noisy population counts
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 17:02:18
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "Emission.h"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <gsl/gsl_sf_gamma.h>
+
+static const double impossible = -std::numeric_limits<double>::infinity();
+
+Emission::Emission() : type(0), custom(nullptr) {}
+
+// exact: none; poisson: detection scale; binomial: detection probability; negbin: size; gaussian: sd; custom: any
+Emission::Emission(std::string dist, std::vector<double> p, EmissionFunction f) : params(p), custom(f){
+	size_t nparams = 1;
+	if(dist == "exact"){
+		type = 0;
+		nparams = 0;
+	} else if(dist == "poisson"){
+		type = 1;
+	} else if(dist == "binomial"){
+		type = 2;
+	} else if(dist == "negbin"){
+		type = 3;
+	} else if(dist == "gaussian"){
+		type = 4;
+	} else if(dist == "custom"){
+		type = 5;
+		nparams = params.size();
+		if(!custom)
+			throw std::invalid_argument("Custom emission needs a density function");
+	} else {
+		throw std::invalid_argument("Unknown emission distribution " + dist);
+	}
+
+	if(params.size() != nparams)
+		throw std::invalid_argument("Wrong number of parameters for emission distribution " + dist);
+}
+
+Emission::~Emission(){}
+
+double Emission::logDensity(double y, double x) const{
+	switch(type){
+		case 0:
+			return y == x ? 0 : impossible;
+		case 1: {
+			double lambda = params[0] * x;
+			if(lambda <= 0)
+				return y == 0 ? 0 : impossible;
+			return y * log(lambda) - lambda - gsl_sf_lngamma(y + 1);
+		}
+		case 2: {
+			double p = params[0];
+			if(y > x)
+				return impossible;
+			if(p <= 0)
+				return y == 0 ? 0 : impossible;
+			if(p >= 1)
+				return y == x ? 0 : impossible;
+			return gsl_sf_lngamma(x + 1) - gsl_sf_lngamma(y + 1) - gsl_sf_lngamma(x - y + 1) + y * log(p) + (x - y) * log1p(-p);
+		}
+		case 3: {
+			double k = params[0];
+			if(x <= 0)
+				return y == 0 ? 0 : impossible;
+			return gsl_sf_lngamma(y + k) - gsl_sf_lngamma(k) - gsl_sf_lngamma(y + 1) + k * log(k / (k + x)) + y * log(x / (k + x));
+		}
+		case 4: {
+			double z = (y - x) / params[0];
+			return -0.5 * z * z - log(params[0]) - 0.5 * log(2 * M_PI);
+		}
+		default:
+			return custom(y, x, params.data());
+	}
+}
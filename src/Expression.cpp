@@ -0,0 +1,99 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Expression.cpp
+ *
+ *    Description:  Rate expressions compiled to reverse Polish notation
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 16:05:33
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+
+#include "Expression.h"
+
+#include <cmath>
+#include <stdexcept>
+
+Expression::Expression(){}
+
+Expression::Expression(std::vector<int> o, std::vector<double> v) : ops(o), values(v){
+	if(ops.size() != values.size())
+		throw std::invalid_argument("Expression needs one value per opcode");
+
+	// Check the stack never underflows or outgrows eval's buffer, and that one value is left
+	int depth = 0;
+	for(size_t i = 0; i < ops.size(); i++){
+		if(ops[i] < OP_CONST || ops[i] > OP_GE)
+			throw std::invalid_argument("Unknown opcode in rate expression");
+
+		if(ops[i] <= OP_PARAM)
+			++depth;
+		else if(ops[i] == OP_NEG || (ops[i] >= OP_EXP && ops[i] <= OP_COS)){
+			if(depth < 1)
+				throw std::invalid_argument("Malformed rate expression");
+		}
+		else {
+			if(depth < 2)
+				throw std::invalid_argument("Malformed rate expression");
+			--depth;
+		}
+		if(depth > maxDepth)
+			throw std::invalid_argument("Rate expression is too deeply nested");
+	}
+	if(depth != 1)
+		throw std::invalid_argument("Malformed rate expression");
+}
+
+Expression::~Expression(){}
+
+double Expression::eval(double time, const double* params) const{
+	double stack[maxDepth];
+	int top = -1;
+	for(size_t i = 0; i < ops.size(); i++){
+		switch(ops[i]){
+			case OP_CONST: stack[++top] = values[i]; break;
+			case OP_TIME: stack[++top] = time; break;
+			case OP_PARAM: stack[++top] = params[(int)values[i]]; break;
+			case OP_ADD: stack[top - 1] += stack[top]; --top; break;
+			case OP_SUB: stack[top - 1] -= stack[top]; --top; break;
+			case OP_MUL: stack[top - 1] *= stack[top]; --top; break;
+			case OP_DIV: stack[top - 1] /= stack[top]; --top; break;
+			case OP_POW: stack[top - 1] = pow(stack[top - 1], stack[top]); --top; break;
+			case OP_NEG: stack[top] = -stack[top]; break;
+			case OP_EXP: stack[top] = exp(stack[top]); break;
+			case OP_LOG: stack[top] = log(stack[top]); break;
+			case OP_SIN: stack[top] = sin(stack[top]); break;
+			case OP_COS: stack[top] = cos(stack[top]); break;
+			case OP_LT: stack[top - 1] = stack[top - 1] < stack[top]; --top; break;
+			case OP_GT: stack[top - 1] = stack[top - 1] > stack[top]; --top; break;
+			case OP_LE: stack[top - 1] = stack[top - 1] <= stack[top]; --top; break;
+			case OP_GE: stack[top - 1] = stack[top - 1] >= stack[top]; --top; break;
+		}
+	}
+	return stack[0];
+}
+
+bool Expression::timeDependent() const{
+	for(size_t i = 0; i < ops.size(); i++){
+		if(ops[i] == OP_TIME)
+			return true;
+	}
+	return false;
+}
+
+int Expression::maxParam() const{
+	int m = -1;
+	for(size_t i = 0; i < ops.size(); i++){
+		if(ops[i] == OP_PARAM && (int)values[i] > m)
+			m = (int)values[i];
+	}
+	return m;
+}
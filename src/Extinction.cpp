@@ -0,0 +1,131 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Extinction.cpp
+ *
+ *    Description:  Extinction probabilities from the backward Kolmogorov equation of the
+ *                  offspring generating function
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 14:05:37
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "Extinction.h"
+#include "ConstantRate.h"
+#include "ModelLoader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+#include <gsl/gsl_errno.h>
+#include <gsl/gsl_odeiv2.h>
+
+extern bool silent;
+
+ExtinctionSolver::ExtinctionSolver(int n) : ntype(n), homogeneous(true), horizon(0) {}
+
+ExtinctionSolver::~ExtinctionSolver(){
+	for(auto i = rates.begin(); i != rates.end(); i++){
+		delete *i;
+	}
+}
+
+void ExtinctionSolver::addTransition(Rate* r, int f, std::vector<int> o){
+	if(o.size() != (size_t)ntype){
+		delete r;
+		throw std::invalid_argument("Offspring vector does not match the number of types");
+	}
+	rates.push_back(r);
+	from.push_back(f);
+	offspring.push_back(o);
+	if(dynamic_cast<ConstantRate*>(r) == nullptr)
+		homogeneous = false;
+}
+
+// With q_i(s) = P(extinct by the horizon T | one type i cell at s) and tau = T - s,
+// dq_i/dtau = sum over transitions r with parent i of rate_r(T - tau) * (prod_j q_j^o_rj - q_i)
+void ExtinctionSolver::derivative(double tau, const double* q, double* dq){
+	std::fill(dq, dq + ntype, 0.0);
+	double time = horizon - tau;
+	for(size_t r = 0; r < rates.size(); r++){
+		double pgf = 1;
+		for(int j = 0; j < ntype; j++){
+			if(offspring[r][j] > 0)
+				pgf *= std::pow(q[j], offspring[r][j]);
+		}
+		dq[from[r]] += (*rates[r])(time) * (pgf - q[from[r]]);
+	}
+}
+
+static int extinction_deriv(double tau, const double q[], double dq[], void* params){
+	static_cast<ExtinctionSolver*>(params)->derivative(tau, q, dq);
+	return GSL_SUCCESS;
+}
+
+std::vector<std::vector<double> > ExtinctionSolver::solve(const std::vector<double>& times){
+	std::vector<std::vector<double> > out(times.size(), std::vector<double>(ntype, 0.0));
+
+	std::vector<size_t> order(times.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&](size_t a, size_t b){ return times[a] < times[b]; });
+
+	gsl_odeiv2_system sys = {extinction_deriv, nullptr, (size_t)ntype, this};
+	gsl_odeiv2_driver* driver = gsl_odeiv2_driver_alloc_y_new(&sys, gsl_odeiv2_step_rk8pd, 1e-6, 1e-10, 1e-10);
+
+	// Constant rates make the equation autonomous, so one forward pass in tau visits every observation time.
+	// Otherwise q depends on the horizon and each observation time needs its own solve back to time 0.
+	std::vector<double> q(ntype, 0.0);
+	double tau = 0;
+	int status = GSL_SUCCESS;
+	for(size_t k = 0; k < order.size() && status == GSL_SUCCESS; k++){
+		double target = times[order[k]];
+		if(!homogeneous){
+			horizon = target;
+			tau = 0;
+			std::fill(q.begin(), q.end(), 0.0);
+			gsl_odeiv2_driver_reset(driver);
+		}
+		if(target > tau)
+			status = gsl_odeiv2_driver_apply(driver, &tau, target, q.data());
+		for(int i = 0; i < ntype; i++)
+			out[order[k]][i] = std::min(1.0, std::max(0.0, q[i]));
+	}
+	gsl_odeiv2_driver_free(driver);
+
+	if(status != GSL_SUCCESS)
+		throw std::runtime_error("Extinction ODE solver failed");
+	return out;
+}
+
+// [[Rcpp::export]]
+Rcpp::NumericMatrix extinctionProb(Rcpp::NumericVector observations, int ntype, Rcpp::List transitions, bool silence){
+	silent = silence;
+	PluginHandles plugins;
+	std::vector<std::vector<double> > q;
+	{
+		ExtinctionSolver solver(ntype);
+		for(int i = 0; i < transitions.length(); i++){
+			Rcpp::List list_i = Rcpp::as<Rcpp::List>(transitions[i]);
+			solver.addTransition(loadRate(list_i, plugins), loadParent(list_i), loadOffspring(list_i));
+		}
+		if(!silent) std::cout << (solver.homogeneous ? "Solving once over the observation grid..." : "Solving per observation time...") << std::endl;
+		q = solver.solve(std::vector<double>(observations.begin(), observations.end()));
+	}
+
+	Rcpp::NumericMatrix out(observations.size(), ntype + 1);
+	for(int k = 0; k < observations.size(); k++){
+		out(k, 0) = observations[k];
+		for(int i = 0; i < ntype; i++)
+			out(k, i + 1) = q[k][i];
+	}
+	return out;
+}
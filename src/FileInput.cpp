@@ -0,0 +1,168 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  FileInput.cpp
+ *
+ *    Description:  Readers for whitespace-separated numbers, line lists and CSV files
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 16:04:12
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "FileInput.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <functional>
+#include <cctype>
+
+// Helper Methods to read in data from text files
+template
+< typename T
+, template<typename ELEM, typename ALLOC=std::allocator<ELEM> > class Container
+>
+std::ostream& operator<< (std::ostream& o, const Container<T>& container)
+{
+	typename Container<T>::const_iterator beg = container.begin();
+
+	o << "["; // 1
+
+	while(beg != container.end())
+	{
+		o << " " << *beg++; // 2
+	}
+
+	o << " ]"; // 3
+
+	return o;
+}
+
+// trim from left
+static inline std::string &ltrim(std::string &s)
+{
+	s.erase(s.begin(), std::find_if(s.begin(), s.end(),
+			std::not1(std::ptr_fun<int, int>(std::isspace))));
+	return s;
+}
+
+// trim from end
+static inline std::string &rtrim(std::string &s)
+{
+	s.erase(std::find_if(s.rbegin(), s.rend(),
+			std::not1(std::ptr_fun<int, int>(std::isspace))).base(), s.end());
+	return s;
+}
+
+// trim from both ends
+static inline std::string &trim(std::string &s)
+{
+	return ltrim(rtrim(s));
+}
+
+
+// Read in a vector matrix
+std::vector<std::vector<double> > fileToVectorMatrix(std::string name)
+{
+	std::vector<std::vector<double> > result;
+	std::ifstream input (name);
+	std::string lineData;
+
+	while(getline(input, lineData))
+	{
+		double d;
+		std::vector<double> row;
+		std::stringstream lineStream(lineData);
+
+		while (lineStream >> d)
+		row.push_back(d);
+
+		result.push_back(row);
+	}
+
+	return result;
+}
+
+template <typename T>
+std::vector<T> flatten(const std::vector<std::vector<T> >& v)
+{
+	std::size_t total_size = 0;
+	for (const auto& sub : v)
+	total_size += sub.size(); // I wish there was a transform_accumulate
+	std::vector<T> result;
+	result.reserve(total_size);
+	for (const auto& sub : v)
+	result.insert(result.end(), sub.begin(), sub.end());
+	return result;
+}
+
+// Read in a vector
+std::vector<double> fileToVector(std::string name)
+{
+	std::vector<std::vector<double> > result;
+	std::ifstream input (name);
+	std::string lineData;
+
+	while(getline(input, lineData))
+	{
+		double d;
+		std::vector<double> row;
+		std::stringstream lineStream(lineData);
+
+		while (lineStream >> d)
+		row.push_back(d);
+
+		result.push_back(row);
+	}
+
+	return flatten(result);
+}
+
+// Read in a text file, output a vector of strings, one string per line, trimmed
+std::vector<std::string> inputStringVector(std::string in)
+{
+	std::string s;
+	std::vector<std::string> a;
+	std::ifstream infile(in);
+	if(infile.is_open())
+	{
+		while(getline(infile, s))
+		{
+			// allow comments
+			std::string::iterator end_pos = std::remove(s.begin(), s.end(), ' ');
+			s.erase(end_pos, s.end());
+			a.push_back(trim(s));
+		}
+	}
+
+	return(a);
+}
+
+std::vector<std::vector<std::string>> funct(std::string filename){
+	std::ifstream csv(filename);
+	std::string line;
+	std::vector <std::vector<std::string>> items;
+
+	if (csv.is_open()) {
+		for (std::string row_line; std::getline(csv, row_line);)
+		{
+			items.emplace_back();
+			std::istringstream row_stream(row_line);
+			for(std::string column; std::getline(row_stream, column, ',');)
+			items.back().push_back(column);
+		}
+	}
+	else {
+		std::cout << "Unable to open file";
+	}
+
+	return items;
+}
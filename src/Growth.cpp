@@ -0,0 +1,288 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Growth.cpp
+ *
+ *    Description:  Malthusian growth rate and stable type distribution
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 15:47:12
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "Growth.h"
+#include "ConstantRate.h"
+#include "ModelLoader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+
+#include <gsl/gsl_errno.h>
+
+extern bool silent;
+
+GrowthSolver::GrowthSolver(int n) : ntype(n), homogeneous(true), krylov(20), transpose(false), growth(0), multiplier(1), period(0),
+	iterations(0), residual(0), shift(0), driver(nullptr) {}
+
+GrowthSolver::~GrowthSolver(){
+	for(auto i = rates.begin(); i != rates.end(); i++){
+		delete *i;
+	}
+	if(driver)
+		gsl_odeiv2_driver_free(driver);
+}
+
+void GrowthSolver::addTransition(Rate* r, int f, std::vector<int> o){
+	if(o.size() != (size_t)ntype){
+		delete r;
+		throw std::invalid_argument("Offspring vector does not match the number of types");
+	}
+	rates.push_back(r);
+	from.push_back(f);
+	offspring.push_back(o);
+	if(dynamic_cast<ConstantRate*>(r) == nullptr)
+		homogeneous = false;
+}
+
+// Row vectors follow the mean population forward, dz/dt = z A(t). Column vectors follow the reproductive value
+// backward from the end of the period, dv/ds = A(T - s) v.
+void GrowthSolver::derivative(double s, const double* x, double* dx){
+	std::fill(dx, dx + ntype, 0.0);
+	double time = transpose ? period - s : s;
+	for(size_t r = 0; r < rates.size(); r++){
+		double rate = (*rates[r])(time);
+		int p = from[r];
+		if(transpose){
+			double v = -x[p];
+			for(int j = 0; j < ntype; j++)
+				v += offspring[r][j] * x[j];
+			dx[p] += rate * v;
+		} else {
+			for(int j = 0; j < ntype; j++)
+				dx[j] += rate * offspring[r][j] * x[p];
+			dx[p] -= rate * x[p];
+		}
+	}
+}
+
+static int growth_deriv(double s, const double x[], double dx[], void* params){
+	static_cast<GrowthSolver*>(params)->derivative(s, x, dx);
+	return GSL_SUCCESS;
+}
+
+void GrowthSolver::apply(const std::vector<double>& x, std::vector<double>& y){
+	iterations++;
+	if(homogeneous){
+		for(int i = 0; i < ntype; i++)
+			y[i] = shift * x[i];
+		for(size_t k = 0; k < vals.size(); k++){
+			if(transpose)
+				y[rows[k]] += vals[k] * x[cols[k]];
+			else
+				y[cols[k]] += x[rows[k]] * vals[k];
+		}
+		return;
+	}
+
+	y = x;
+	double s = 0;
+	gsl_odeiv2_driver_reset(driver);
+	if(gsl_odeiv2_driver_apply(driver, &s, period, y.data()) != GSL_SUCCESS)
+		throw std::runtime_error("Growth ODE solver failed");
+}
+
+static double dot(const std::vector<double>& a, const std::vector<double>& b){
+	return std::inner_product(a.begin(), a.end(), b.begin(), 0.0);
+}
+
+// Dominant eigenpair of the leading k x k block of the Hessenberg matrix h (leading dimension ld), by power iteration.
+// The block is small, so this is cheap however slowly it converges.
+static double dominantRitz(const std::vector<double>& h, int ld, int k, std::vector<double>& y){
+	std::vector<double> z(k);
+	y.assign(k, 0.0);
+	y[0] = 1;
+	double theta = 0;
+	for(int it = 0; it < 100000; it++){
+		std::fill(z.begin(), z.end(), 0.0);
+		for(int j = 0; j < k; j++)
+			for(int i = 0; i <= std::min(j + 1, k - 1); i++)
+				z[i] += h[i + ld*j] * y[j];
+		theta = std::inner_product(y.begin(), y.begin() + k, z.begin(), 0.0);
+		double nz = sqrt(std::inner_product(z.begin(), z.end(), z.begin(), 0.0));
+		if(nz == 0)
+			break;
+		double change = 0;
+		for(int i = 0; i < k; i++){
+			change = std::max(change, fabs(z[i] / nz - y[i]));
+			y[i] = z[i] / nz;
+		}
+		if(change < 1e-15)
+			break;
+	}
+	return theta;
+}
+
+// Explicitly restarted Arnoldi: each cycle builds a Krylov basis from the current estimate and restarts from the
+// dominant Ritz vector, until the eigen-residual |op x - theta x| falls below tol |theta|
+double GrowthSolver::arnoldi(std::vector<double>& x, double tol, int maxRestarts){
+	int n = ntype;
+	int m = std::min(krylov, n);
+	std::vector<std::vector<double> > V(m + 1, std::vector<double>(n));
+	std::vector<double> h((m + 1) * m), w(n), y;
+
+	double nx = sqrt(dot(x, x));
+	for(int i = 0; i < n; i++)
+		x[i] /= nx;
+
+	double theta = 0;
+	for(int restart = 0; restart <= maxRestarts; restart++){
+		V[0] = x;
+		apply(V[0], w);
+		theta = dot(x, w);
+		double scale = sqrt(dot(w, w));
+		double res = 0;
+		for(int i = 0; i < n; i++)
+			res += (w[i] - theta * x[i]) * (w[i] - theta * x[i]);
+		residual = sqrt(res) / std::max(fabs(theta), 1e-300);
+		if(residual <= tol || restart == maxRestarts || scale == 0)
+			break;
+
+		std::fill(h.begin(), h.end(), 0.0);
+		int k = m;
+		for(int j = 0; j < m; j++){
+			if(j > 0)
+				apply(V[j], w);
+			// Classical Gram-Schmidt, twice
+			for(int pass = 0; pass < 2; pass++){
+				for(int i = 0; i <= j; i++){
+					double c = dot(V[i], w);
+					h[i + (m + 1)*j] += c;
+					for(int l = 0; l < n; l++)
+						w[l] -= c * V[i][l];
+				}
+			}
+			double beta = sqrt(dot(w, w));
+			h[j + 1 + (m + 1)*j] = beta;
+			if(beta <= 1e-13 * scale){
+				k = j + 1; // the basis spans an invariant subspace
+				break;
+			}
+			for(int l = 0; l < n; l++)
+				V[j + 1][l] = w[l] / beta;
+		}
+
+		dominantRitz(h, m + 1, k, y);
+		std::fill(x.begin(), x.end(), 0.0);
+		for(int i = 0; i < k; i++)
+			for(int l = 0; l < n; l++)
+				x[l] += y[i] * V[i][l];
+		nx = sqrt(dot(x, x));
+		for(int i = 0; i < n; i++)
+			x[i] /= nx;
+		Rcpp::checkUserInterrupt();
+	}
+	return theta;
+}
+
+void GrowthSolver::solve(double p, double tol, int maxRestarts){
+	period = p;
+	if(homogeneous){
+		// Sparse generator, one entry per (parent, offspring type) pair
+		std::map<std::pair<int, int>, double> a;
+		for(size_t r = 0; r < rates.size(); r++){
+			double rate = (*rates[r])(0);
+			for(int j = 0; j < ntype; j++)
+				if(offspring[r][j] != 0)
+					a[std::make_pair(from[r], j)] += rate * offspring[r][j];
+			a[std::make_pair(from[r], from[r])] -= rate;
+		}
+		rows.clear();
+		cols.clear();
+		vals.clear();
+		double scale = 0;
+		shift = 0;
+		for(auto e = a.begin(); e != a.end(); e++){
+			rows.push_back(e->first.first);
+			cols.push_back(e->first.second);
+			vals.push_back(e->second);
+			scale = std::max(scale, fabs(e->second));
+			if(e->first.first == e->first.second)
+				shift = std::max(shift, -e->second);
+		}
+		shift += 0.01 * scale + 1e-300;
+	} else {
+		// Rates that know their period, such as PulseRate, must share it when none is given
+		if(period <= 0){
+			for(size_t r = 0; r < rates.size(); r++){
+				if(dynamic_cast<ConstantRate*>(rates[r]) != nullptr)
+					continue;
+				double q = rates[r]->period();
+				if(q <= 0)
+					throw std::invalid_argument("Time-dependent rates need a period");
+				if(period > 0 && fabs(q - period) > 1e-12 * period)
+					throw std::invalid_argument("Time-dependent rates do not share a period");
+				period = q;
+			}
+		}
+		gsl_odeiv2_system sys = {growth_deriv, nullptr, (size_t)ntype, this};
+		if(driver)
+			gsl_odeiv2_driver_free(driver);
+		driver = gsl_odeiv2_driver_alloc_y_new(&sys, gsl_odeiv2_step_rk8pd, period / 100, 1e-12, 1e-10);
+	}
+
+	iterations = 0;
+	transpose = false;
+	left.assign(ntype, 1.0);
+	double theta = arnoldi(left, tol, maxRestarts);
+	double leftResidual = residual;
+
+	transpose = true;
+	right.assign(ntype, 1.0);
+	arnoldi(right, tol, maxRestarts);
+	residual = std::max(leftResidual, residual);
+
+	if(homogeneous){
+		growth = theta - shift;
+		multiplier = exp(growth);
+	} else {
+		multiplier = theta;
+		growth = log(theta) / period;
+	}
+
+	double total = std::accumulate(left.begin(), left.end(), 0.0);
+	for(int i = 0; i < ntype; i++)
+		left[i] /= total;
+	double norm = dot(left, right);
+	for(int i = 0; i < ntype; i++)
+		right[i] /= norm;
+}
+
+// [[Rcpp::export]]
+Rcpp::List growthRate(int ntype, Rcpp::List transitions, double period, double tol, int max_restarts, bool silence){
+	silent = silence;
+	PluginHandles plugins;
+	GrowthSolver solver(ntype);
+	for(int i = 0; i < transitions.length(); i++){
+		Rcpp::List list_i = Rcpp::as<Rcpp::List>(transitions[i]);
+		solver.addTransition(loadRate(list_i, plugins), loadParent(list_i), loadOffspring(list_i));
+	}
+	if(!silent) std::cout << (solver.homogeneous ? "Solving for the dominant eigenvalue of the mean generator..." : "Solving for the dominant Floquet multiplier...") << std::endl;
+	solver.solve(period, tol, max_restarts);
+
+	return Rcpp::List::create(Rcpp::Named("rate") = solver.growth,
+	                          Rcpp::Named("multiplier") = solver.multiplier,
+	                          Rcpp::Named("period") = solver.period,
+	                          Rcpp::Named("stable") = Rcpp::wrap(solver.left),
+	                          Rcpp::Named("reproductive") = Rcpp::wrap(solver.right),
+	                          Rcpp::Named("iterations") = solver.iterations,
+	                          Rcpp::Named("residual") = solver.residual);
+}
@@ -0,0 +1,169 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Langevin.cpp
+ *
+ *    Description:  Chemical Langevin simulation of blocks of replicates in lockstep
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 18:58:27
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "Langevin.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <gsl/gsl_rng.h>
+
+#include <Rcpp.h>
+
+extern gsl_rng* rng;
+extern bool silent;
+
+LangevinBlock::LangevinBlock(System& s, int l) : sys(s), ntype(s.state.size()), lanes(l){
+	for(size_t r = 0; r < sys.updates.size(); r++){
+		std::vector<int> d = sys.updates[r].get();
+		d[sys.from[r]] -= 1;
+		deltas.push_back(d);
+	}
+	x.resize(ntype * lanes);
+	a.resize(deltas.size() * lanes);
+	z.resize(lanes + 1);
+	active.resize(lanes);
+	rows.resize(lanes);
+}
+
+LangevinBlock::~LangevinBlock(){}
+
+// Box-Muller on arrays of uniforms: both outputs of each pair are used and the transform loop has no branches
+void LangevinBlock::normals(int n){
+	int pairs = (n + 1) / 2;
+	for(int k = 0; k < pairs; k++){
+		z[2*k] = gsl_rng_uniform_pos(rng);
+		z[2*k + 1] = gsl_rng_uniform(rng);
+	}
+	#pragma omp simd
+	for(int k = 0; k < pairs; k++){
+		double radius = std::sqrt(-2 * std::log(z[2*k]));
+		double angle = 2 * M_PI * z[2*k + 1];
+		z[2*k] = radius * std::cos(angle);
+		z[2*k + 1] = radius * std::sin(angle);
+	}
+}
+
+void LangevinBlock::step(double time, double dt){
+	int R = sys.rates2.size();
+	double sdt = std::sqrt(dt);
+
+	// All increments are drawn from the state at the start of the step before any is applied
+	for(int r = 0; r < R; r++){
+		double rate = (*sys.rates2[r])(time);
+		const double* parent = &x[sys.from[r] * lanes];
+		double* ar = &a[r * lanes];
+
+		// Frozen lanes get zero propensity, so they stay put
+		normals(lanes);
+		#pragma omp simd
+		for(int l = 0; l < lanes; l++){
+			double prop = active[l] ? rate * parent[l] : 0.0;
+			ar[l] = prop * dt + std::sqrt(prop) * sdt * z[l];
+		}
+	}
+
+	for(int r = 0; r < R; r++){
+		const double* ar = &a[r * lanes];
+		for(int j = 0; j < ntype; j++){
+			if(deltas[r][j] == 0)
+				continue;
+			double nu = deltas[r][j];
+			double* xj = &x[j * lanes];
+			#pragma omp simd
+			for(int l = 0; l < lanes; l++)
+				xj[l] += nu * ar[l];
+		}
+	}
+
+	// Absorbing boundary at zero
+	#pragma omp simd
+	for(int k = 0; k < ntype * lanes; k++)
+		x[k] = std::max(x[k], 0.0);
+}
+
+void LangevinBlock::record(int lane, int rep, double time){
+	std::ostringstream row;
+	row << rep << "," << time;
+	for(int j = 0; j < ntype; j++)
+		row << "," << x[j * lanes + lane];
+	row << "\n";
+	rows[lane] += row.str();
+}
+
+void LangevinBlock::simulate(std::vector<double> obsTimes, std::string file, int firstRep, int nreps, double dt){
+	int used = std::min(lanes, nreps);
+	for(int j = 0; j < ntype; j++){
+		for(int l = 0; l < lanes; l++)
+			x[j * lanes + l] = sys.state[j];
+	}
+	for(int l = 0; l < lanes; l++){
+		active[l] = l < used;
+		rows[l].clear();
+	}
+
+	std::vector<long int> rounded(ntype);
+	double curTime = 0;
+	size_t curObsIndex = 0;
+	int running = used;
+	while(running > 0 && curObsIndex < obsTimes.size()){
+		Rcpp::checkUserInterrupt();
+
+		// Never step across an observation time
+		double h = std::min(dt, obsTimes[curObsIndex] - curTime);
+		if(h > 0){
+			step(curTime, h);
+			curTime += h;
+		}
+
+		bool observe = curTime >= obsTimes[curObsIndex];
+		for(int l = 0; l < used; l++){
+			if(!active[l])
+				continue;
+			if(observe)
+				record(l, firstRep + l, obsTimes[curObsIndex]);
+
+			double total = 0;
+			for(int j = 0; j < ntype; j++){
+				rounded[j] = std::lround(x[j * lanes + l]);
+				total += x[j * lanes + l];
+			}
+			bool stop = false;
+			for(size_t i = 0; i < sys.stops.size(); i++){
+				if(sys.stops[i].check(rounded))
+					stop = true;
+			}
+
+			// Stopped and extinct lanes write their final state and freeze, as in System::simulate
+			if(stop || total == 0){
+				if(!observe)
+					record(l, firstRep + l, curTime);
+				active[l] = false;
+				running--;
+			}
+		}
+		if(observe)
+			curObsIndex++;
+	}
+
+	std::ofstream of;
+	of.open(file, std::fstream::in | std::fstream::out | std::fstream::app);
+	for(int l = 0; l < used; l++)
+		of << rows[l];
+}
@@ -0,0 +1,79 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Lifetime.cpp
+ *
+ *    Description:  Lifetime distributions for age-dependent branching processes
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 14:48:12
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "Lifetime.h"
+
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <gsl/gsl_randist.h>
+
+extern gsl_rng* rng;
+
+Lifetime::Lifetime() : type(0), params(1, 1.0) {}
+
+// exponential: rate; gamma: shape, scale; lognormal: meanlog, sdlog; empirical: observed lifetimes
+Lifetime::Lifetime(std::string dist, std::vector<double> p) : params(p){
+	size_t nparams;
+	if(dist == "exponential"){
+		type = 0;
+		nparams = 1;
+	} else if(dist == "gamma"){
+		type = 1;
+		nparams = 2;
+	} else if(dist == "lognormal"){
+		type = 2;
+		nparams = 2;
+	} else if(dist == "empirical"){
+		type = 3;
+		nparams = params.size();
+	} else {
+		throw std::invalid_argument("Unknown lifetime distribution " + dist);
+	}
+
+	if(params.size() != nparams || params.empty())
+		throw std::invalid_argument("Wrong number of parameters for lifetime distribution " + dist);
+}
+
+Lifetime::~Lifetime(){}
+
+double Lifetime::sample(){
+	switch(type){
+		case 0:
+			return gsl_ran_exponential(rng, 1 / params[0]);
+		case 1:
+			return gsl_ran_gamma(rng, params[0], params[1]);
+		case 2:
+			return gsl_ran_lognormal(rng, params[0], params[1]);
+		default:
+			return params[gsl_rng_uniform_int(rng, params.size())];
+	}
+}
+
+double Lifetime::mean(){
+	switch(type){
+		case 0:
+			return 1 / params[0];
+		case 1:
+			return params[0] * params[1];
+		case 2:
+			return std::exp(params[0] + params[1] * params[1] / 2);
+		default:
+			return std::accumulate(params.begin(), params.end(), 0.0) / params.size();
+	}
+}
@@ -0,0 +1,276 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Likelihood.cpp
+ *
+ *    Description:  Gaussian moment likelihood of observed populations
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 10:12:40
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "Likelihood.h"
+#include "helpers.h"
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <stdexcept>
+
+#ifndef ESTIPOP_STANDALONE
+#include <Rcpp.h>
+#endif
+
+MomentTable::MomentTable(const double* mom, int nrow, int ncol, int n) : ntype(n), width(ncol - 2){
+	nparam = width / (n*n + n*n*n) - 1;
+
+	// mom is the column-major matrix returned by moments(): tf, time, then the state vector
+	values.resize((size_t)nrow * width);
+	for(int r = 0; r < nrow; ++r){
+		index[std::make_pair(mom[r], mom[r + nrow])] = r;
+		for(int c = 0; c < width; ++c){
+			values[(size_t)r * width + c] = mom[r + (size_t)nrow * (c + 2)];
+		}
+	}
+}
+
+MomentTable::~MomentTable(){}
+
+const double* MomentTable::find(double tf, double dt) const{
+	std::map<std::pair<double, double>, int>::const_iterator it = index.find(std::make_pair(tf, dt));
+	if(it == index.end())
+		return nullptr;
+	return &values[(size_t)it->second * width];
+}
+
+void MomentTable::meanCov(const double* row, const double* init, std::vector<double>& mu, std::vector<double>& sigma) const{
+	int n = ntype;
+	const double* m = row;            // m[k + n*i] = E[Z_i | one type k ancestor]
+	const double* d = row + n*n;      // d[k + n*(i + n*j)] = E[Z_i Z_j | one type k ancestor]
+
+	for(int i = 0; i < n; ++i){
+		mu[i] = 0;
+		for(int k = 0; k < n; ++k)
+			mu[i] += init[k] * m[k + n*i];
+	}
+
+	for(int j = 0; j < n; ++j){
+		for(int i = 0; i < n; ++i){
+			double s = 0;
+			for(int k = 0; k < n; ++k)
+				s += init[k] * (d[k + n*(i + n*j)] - m[k + n*i] * m[k + n*j]);
+			sigma[i + n*j] = s;
+		}
+	}
+}
+
+void MomentTable::meanCovGrad(const double* row, const double* init, int k, std::vector<double>& dmu, std::vector<double>& dsigma) const{
+	int n = ntype;
+	const double* m = row;
+	const double* dm = row + (n*n + n*n*n)*(k + 1); // derivatives of the moments with respect to parameter k
+	const double* dd = dm + n*n;
+
+	for(int i = 0; i < n; ++i){
+		dmu[i] = 0;
+		for(int l = 0; l < n; ++l)
+			dmu[i] += init[l] * dm[l + n*i];
+	}
+
+	for(int j = 0; j < n; ++j){
+		for(int i = 0; i < n; ++i){
+			double s = 0;
+			for(int l = 0; l < n; ++l)
+				s += init[l] * (dd[l + n*(i + n*j)] - dm[l + n*i] * m[l + n*j] - m[l + n*i] * dm[l + n*j]);
+			dsigma[i + n*j] = s;
+		}
+	}
+}
+
+double gaussianLoglik(const MomentTable& mom, const std::vector<double>& init, const std::vector<double>& start,
+                      const std::vector<double>& end, const std::vector<double>& final, int nobs,
+                      std::vector<double>* grad){
+	int n = mom.ntype;
+	int p = grad ? mom.nparam : 0;
+	if(grad)
+		grad->assign(p, 0.0);
+
+	// Look up each observation's interval once
+	std::vector<const double*> rows(nobs);
+	for(int obs = 0; obs < nobs; ++obs){
+		rows[obs] = mom.find(end[obs], end[obs] - start[obs]);
+		if(rows[obs] == nullptr)
+			throw std::invalid_argument("no moments computed for observation interval");
+	}
+
+	// Group observations sharing an interval and an initial population
+	std::vector<int> order(nobs);
+	for(int obs = 0; obs < nobs; ++obs)
+		order[obs] = obs;
+
+	std::sort(order.begin(), order.end(), [&](int a, int b){
+		if(rows[a] != rows[b])
+			return rows[a] < rows[b];
+		for(int k = 0; k < n; ++k){
+			if(init[a + (size_t)nobs*k] != init[b + (size_t)nobs*k])
+				return init[a + (size_t)nobs*k] < init[b + (size_t)nobs*k];
+		}
+		return false;
+	});
+
+	std::vector<int> groups;
+	for(int g = 0; g < nobs; ++g){
+		if(g == 0 || rows[order[g]] != rows[order[g-1]]){
+			groups.push_back(g);
+			continue;
+		}
+		for(int k = 0; k < n; ++k){
+			if(init[order[g] + (size_t)nobs*k] != init[order[g-1] + (size_t)nobs*k]){
+				groups.push_back(g);
+				break;
+			}
+		}
+	}
+	groups.push_back(nobs);
+
+	int ngroups = groups.size() - 1;
+	double ll = 0;
+	bool singular = false;
+
+	#pragma omp parallel reduction(+:ll) reduction(||:singular)
+	{
+		std::vector<double> x0(n), mu(n), sigma(n*n), resid(n), alpha(n);
+		std::vector<double> sigmaInv(n*n), dmu(p*n), dsigma(p*n*n), dm(n), ds(n*n), localGrad(p, 0.0);
+
+		#pragma omp for schedule(dynamic)
+		for(int g = 0; g < ngroups; ++g){
+			int first = order[groups[g]];
+			int count = groups[g+1] - groups[g];
+			for(int k = 0; k < n; ++k)
+				x0[k] = init[first + (size_t)nobs*k];
+
+			mom.meanCov(rows[first], x0.data(), mu, sigma);
+			if(!cholesky(sigma, n)){
+				singular = true;
+				continue;
+			}
+
+			double logdet = 0;
+			for(int i = 0; i < n; ++i)
+				logdet += 2*log(sigma[i + n*i]);
+
+			double quad = 0;
+			for(int o = groups[g]; o < groups[g+1]; ++o){
+				for(int i = 0; i < n; ++i)
+					resid[i] = final[order[o] + (size_t)nobs*i] - mu[i];
+				quad += forwardSolveNorm(sigma, n, resid);
+			}
+			ll += -count*(n/2.0*log(2*M_PI) + logdet/2) - quad/2;
+
+			if(p == 0)
+				continue;
+
+			// dl/dtheta = sum_o [alpha_o' dmu + alpha_o' dSigma alpha_o / 2] - count/2 tr(Sigma^-1 dSigma), alpha_o = Sigma^-1 (x_o - mu)
+			for(int k = 0; k < p; ++k){
+				mom.meanCovGrad(rows[first], x0.data(), k, dm, ds);
+				std::copy(dm.begin(), dm.end(), dmu.begin() + k*n);
+				std::copy(ds.begin(), ds.end(), dsigma.begin() + k*n*n);
+			}
+
+			for(int j = 0; j < n; ++j){
+				std::fill(alpha.begin(), alpha.end(), 0.0);
+				alpha[j] = 1;
+				choleskySolve(sigma, n, alpha);
+				std::copy(alpha.begin(), alpha.end(), sigmaInv.begin() + j*n);
+			}
+
+			for(int k = 0; k < p; ++k){
+				double tr = 0;
+				for(int i = 0; i < n*n; ++i)
+					tr += sigmaInv[i] * dsigma[k*n*n + i];
+				localGrad[k] -= count*tr/2;
+			}
+
+			for(int o = groups[g]; o < groups[g+1]; ++o){
+				for(int i = 0; i < n; ++i)
+					alpha[i] = final[order[o] + (size_t)nobs*i] - mu[i];
+				choleskySolve(sigma, n, alpha);
+
+				for(int k = 0; k < p; ++k){
+					double lin = 0, quadGrad = 0;
+					for(int i = 0; i < n; ++i){
+						lin += alpha[i] * dmu[k*n + i];
+						for(int j = 0; j < n; ++j)
+							quadGrad += alpha[i] * dsigma[k*n*n + i + n*j] * alpha[j];
+					}
+					localGrad[k] += lin + quadGrad/2;
+				}
+			}
+		}
+
+		if(p > 0){
+			#pragma omp critical
+			for(int k = 0; k < p; ++k)
+				(*grad)[k] += localGrad[k];
+		}
+	}
+
+	if(singular)
+		return -std::numeric_limits<double>::infinity();
+	return ll;
+}
+
+#ifndef ESTIPOP_STANDALONE
+// [[Rcpp::export]]
+double bpLoglik(Rcpp::NumericMatrix mom, Rcpp::NumericMatrix init_pop, Rcpp::NumericVector start_times, Rcpp::NumericVector end_times, Rcpp::NumericMatrix final_pop){
+	int nobs = init_pop.nrow();
+	int ntype = init_pop.ncol();
+
+	MomentTable table(mom.begin(), mom.nrow(), mom.ncol(), ntype);
+
+	std::vector<double> init(init_pop.begin(), init_pop.end());
+	std::vector<double> final(final_pop.begin(), final_pop.end());
+	std::vector<double> start(start_times.begin(), start_times.end());
+	std::vector<double> end(end_times.begin(), end_times.end());
+
+	double ll = 0;
+	try{
+		ll = gaussianLoglik(table, init, start, end, final, nobs);
+	}
+	catch(std::invalid_argument& e){
+		Rcpp::stop(e.what());
+	}
+	return ll;
+}
+
+// [[Rcpp::export]]
+Rcpp::NumericVector bpLoglikGrad(Rcpp::NumericMatrix mom, Rcpp::NumericMatrix init_pop, Rcpp::NumericVector start_times, Rcpp::NumericVector end_times, Rcpp::NumericMatrix final_pop){
+	int nobs = init_pop.nrow();
+	int ntype = init_pop.ncol();
+
+	MomentTable table(mom.begin(), mom.nrow(), mom.ncol(), ntype);
+
+	std::vector<double> init(init_pop.begin(), init_pop.end());
+	std::vector<double> final(final_pop.begin(), final_pop.end());
+	std::vector<double> start(start_times.begin(), start_times.end());
+	std::vector<double> end(end_times.begin(), end_times.end());
+
+	// the log-likelihood followed by its gradient
+	std::vector<double> grad;
+	Rcpp::NumericVector res(table.nparam + 1);
+	try{
+		res[0] = gaussianLoglik(table, init, start, end, final, nobs, &grad);
+	}
+	catch(std::invalid_argument& e){
+		Rcpp::stop(e.what());
+	}
+	std::copy(grad.begin(), grad.end(), res.begin() + 1);
+	return res;
+}
+#endif
@@ -0,0 +1,136 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Lineage.cpp
+ *
+ *    Description:  Clone genealogy recorded in a node arena with incremental pruning
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 16:52:18
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "Lineage.h"
+
+#include <algorithm>
+
+NodeArena::NodeArena() : used(blockSize) {}
+
+NodeArena::~NodeArena(){
+	for(auto i = blocks.begin(); i != blocks.end(); i++){
+		delete[] *i;
+	}
+}
+
+CloneNode* NodeArena::alloc(){
+	if(!freed.empty()){
+		CloneNode* node = freed.back();
+		freed.pop_back();
+		return node;
+	}
+	if(used == blockSize){
+		blocks.push_back(new CloneNode[blockSize]);
+		used = 0;
+	}
+	return &blocks.back()[used++];
+}
+
+void NodeArena::release(CloneNode* node){
+	node->alive = false;
+	node->index = -2;
+	freed.push_back(node);
+}
+
+// Keeps the first block so replicates do not reallocate
+void NodeArena::clear(){
+	for(size_t b = 1; b < blocks.size(); b++){
+		delete[] blocks[b];
+	}
+	if(!blocks.empty())
+		blocks.resize(1);
+	used = blocks.empty() ? blockSize : 0;
+	freed.clear();
+}
+
+Lineage::Lineage() : size(0) {}
+
+Lineage::~Lineage(){}
+
+void Lineage::clear(){
+	arena.clear();
+	live.clear();
+	size = 0;
+}
+
+void Lineage::root(long long id){
+	CloneNode* node = arena.alloc();
+	*node = {nullptr, 0.0, id, -1, 0, true, -1};
+	live[id] = node;
+	size++;
+}
+
+void Lineage::birth(long long id, long long parent, double time, int rule){
+	CloneNode* p = live.count(parent) ? live[parent] : nullptr;
+	CloneNode* node = arena.alloc();
+	*node = {p, time, id, rule, 0, true, -1};
+	if(p)
+		p->children++;
+	live[id] = node;
+	size++;
+}
+
+void Lineage::extinct(long long id){
+	auto it = live.find(id);
+	if(it == live.end())
+		return;
+	CloneNode* node = it->second;
+	live.erase(it);
+	node->alive = false;
+	if(node->children == 0)
+		prune(node);
+}
+
+// Remove a dead, childless clone and any ancestors that become dead and childless as a result
+void Lineage::prune(CloneNode* node){
+	while(node && !node->alive && node->children == 0){
+		CloneNode* p = node->parent;
+		arena.release(node);
+		size--;
+		if(p)
+			p->children--;
+		node = p;
+	}
+}
+
+void Lineage::collect(std::vector<long long>& id, std::vector<int>& parent, std::vector<double>& time, std::vector<int>& rule){
+	std::vector<CloneNode*> nodes;
+	nodes.reserve(size);
+	for(size_t b = 0; b < arena.blocks.size(); b++){
+		size_t n = (b + 1 == arena.blocks.size()) ? arena.used : NodeArena::blockSize;
+		for(size_t i = 0; i < n; i++){
+			if(arena.blocks[b][i].index != -2)
+				nodes.push_back(&arena.blocks[b][i]);
+		}
+	}
+	std::stable_sort(nodes.begin(), nodes.end(), [](const CloneNode* a, const CloneNode* b){ return a->time < b->time; });
+
+	for(size_t i = 0; i < nodes.size(); i++){
+		nodes[i]->index = i;
+	}
+	id.resize(nodes.size());
+	parent.resize(nodes.size());
+	time.resize(nodes.size());
+	rule.resize(nodes.size());
+	for(size_t i = 0; i < nodes.size(); i++){
+		id[i] = nodes[i]->id;
+		parent[i] = nodes[i]->parent ? nodes[i]->parent->index : -1;
+		time[i] = nodes[i]->time;
+		rule[i] = nodes[i]->rule;
+	}
+}
@@ -0,0 +1,187 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Lockstep.cpp
+ *
+ *    Description:  Exact SSA advancing several replicates together in lanes
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 19:40:55
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "Lockstep.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <gsl/gsl_rng.h>
+
+#include <Rcpp.h>
+
+extern gsl_rng* rng;
+extern bool silent;
+
+LockstepSSA::LockstepSSA(System& s, int w) : sys(s), ntype(s.state.size()), nrates(s.rates.size()), lanes(w){
+	for(int r = 0; r < nrates; r++){
+		std::vector<int> d = sys.updates[r].get();
+		d[sys.from[r]] -= 1;
+		deltas.push_back(std::vector<double>(d.begin(), d.end()));
+	}
+	x.resize(ntype * lanes);
+	a.resize(nrates * lanes);
+	total.resize(lanes);
+	u.resize(2 * lanes);
+	wait.resize(lanes);
+	time.resize(lanes);
+	event.resize(lanes);
+	rep.resize(lanes);
+	obsIndex.resize(lanes);
+	live.resize(lanes);
+}
+
+LockstepSSA::~LockstepSSA(){}
+
+void LockstepSSA::fill(int lane, int r){
+	rep[lane] = r;
+	time[lane] = 0;
+	obsIndex[lane] = 0;
+	for(int j = 0; j < ntype; j++)
+		x[j * lanes + lane] = r > 0 ? sys.state[j] : 0;
+	if(r > 0)
+		pending[r] = std::string();
+}
+
+void LockstepSSA::record(int lane, double t){
+	std::ostringstream row;
+	row << rep[lane] << "," << t;
+	for(int j = 0; j < ntype; j++)
+		row << "," << (long int)x[j * lanes + lane];
+	row << "\n";
+	pending[rep[lane]] += row.str();
+}
+
+// Retire the lane's replicate, write every completed replicate that is next in order, and refill the lane
+void LockstepSSA::finish(int lane, int reps, std::ofstream& of){
+	completed.insert(rep[lane]);
+	while(completed.count(nextWrite)){
+		of << pending[nextWrite];
+		pending.erase(nextWrite);
+		completed.erase(nextWrite);
+		nextWrite++;
+	}
+	fill(lane, nextRep <= reps ? nextRep++ : 0);
+}
+
+void LockstepSSA::simulate(std::vector<double> obsTimes, std::string file, int reps){
+	std::ofstream of;
+	of.open(file, std::fstream::in | std::fstream::out | std::fstream::app);
+
+	nextRep = 1;
+	nextWrite = 1;
+	pending.clear();
+	completed.clear();
+	for(int l = 0; l < lanes; l++)
+		fill(l, nextRep <= reps ? nextRep++ : 0);
+
+	double totTime = obsTimes[obsTimes.size()-1];
+	std::vector<long int> state(ntype);
+	long int iter = 0;
+	while(nextWrite <= reps){
+		if((++iter & 0xFFFF) == 0)
+			Rcpp::checkUserInterrupt();
+
+		// Propensities and totals for every lane; idle lanes hold zero populations
+		std::fill(total.begin(), total.end(), 0.0);
+		for(int r = 0; r < nrates; r++){
+			double rate = sys.rates[r];
+			const double* parent = &x[sys.from[r] * lanes];
+			double* ar = &a[r * lanes];
+			#pragma omp simd
+			for(int l = 0; l < lanes; l++){
+				ar[l] = rate * parent[l];
+				total[l] += ar[l];
+			}
+		}
+
+		for(int k = 0; k < 2 * lanes; k++)
+			u[k] = gsl_rng_uniform_pos(rng);
+
+		// Exponential waiting times, and the event index as the count of cumulative propensities below the target
+		#pragma omp simd
+		for(int l = 0; l < lanes; l++){
+			wait[l] = -std::log(u[l]) / total[l];
+			u[lanes + l] *= total[l];
+			event[l] = 0;
+		}
+		for(int r = 0; r < nrates - 1; r++){
+			const double* ar = &a[r * lanes];
+			#pragma omp simd
+			for(int l = 0; l < lanes; l++){
+				u[lanes + l] -= ar[l];
+				event[l] += u[lanes + l] > 0;
+			}
+		}
+
+		// Observations due before each lane's next event; lanes past the last observation retire without the event
+		for(int l = 0; l < lanes; l++){
+			live[l] = rep[l] > 0;
+			if(!live[l])
+				continue;
+			double next = time[l] + wait[l];
+			while(obsIndex[l] < obsTimes.size() && next > obsTimes[obsIndex[l]]){
+				record(l, obsTimes[obsIndex[l]]);
+				obsIndex[l]++;
+			}
+			if(next > totTime)
+				live[l] = 0;
+			else
+				time[l] = next;
+		}
+
+		// Masked update: every live lane adds the change of the event it selected, other lanes add nothing
+		for(int r = 0; r < nrates; r++){
+			for(int j = 0; j < ntype; j++){
+				double d = deltas[r][j];
+				if(d == 0)
+					continue;
+				double* xj = &x[j * lanes];
+				#pragma omp simd
+				for(int l = 0; l < lanes; l++)
+					xj[l] = std::max(0.0, xj[l] + (live[l] && event[l] == r ? d : 0.0));
+			}
+		}
+
+		// Stopping criteria and extinction end the replicate with a row at the event time, as in System::simulate
+		for(int l = 0; l < lanes; l++){
+			if(rep[l] == 0)
+				continue;
+			if(!live[l]){
+				finish(l, reps, of);
+				continue;
+			}
+			bool zero = true;
+			for(int j = 0; j < ntype; j++){
+				state[j] = (long int)x[j * lanes + l];
+				if(state[j] > 0)
+					zero = false;
+			}
+			bool stop = zero;
+			for(size_t i = 0; i < sys.stops.size(); i++){
+				if(sys.stops[i].check(state))
+					stop = true;
+			}
+			if(stop){
+				record(l, time[l]);
+				finish(l, reps, of);
+			}
+		}
+	}
+}
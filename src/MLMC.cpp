@@ -0,0 +1,237 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  MLMC.cpp
+ *
+ *    Description:  Multilevel Monte Carlo with coupled tau-leap and exact paths
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 18:12:03
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "MLMC.h"
+#include "helpers.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <gsl/gsl_randist.h>
+
+#include <Rcpp.h>
+
+extern gsl_rng* rng;
+extern bool silent;
+
+double LevelStats::mean() const{
+	return samples > 0 ? sum / samples : 0;
+}
+
+double LevelStats::variance() const{
+	if(samples < 2)
+		return 0;
+	return std::max(0.0, (sumSq - sum * sum / samples) / (samples - 1));
+}
+
+double LevelStats::cost() const{
+	return samples > 0 ? std::max(seconds / samples, 1e-9) : 0;
+}
+
+MLMC::MLMC(System& sys, std::vector<long int> i, double T, std::vector<double> w, bool e, double h, int M, int L)
+	: rates(sys.rates), from(sys.from), init(i), weights(w), extinct(e), horizon(T), h0(h), refine(M), nlevels(L){
+	if(nlevels < 1 || refine < 2)
+		throw std::invalid_argument("Need at least one tau-leap level and a refinement factor of at least 2");
+	deltas = transitionDeltas(sys.updates, from);
+	stats.resize(nlevels + 1);
+	for(int l = 0; l <= nlevels; l++){
+		stats[l] = LevelStats{l < nlevels ? h0 / std::pow(refine, l) : 0.0, 0, 0, 0, 0};
+	}
+}
+
+MLMC::~MLMC(){}
+
+double MLMC::f(const std::vector<long int>& x){
+	if(extinct){
+		for(size_t i = 0; i < x.size(); i++){
+			if(x[i] > 0)
+				return 0;
+		}
+		return 1;
+	}
+	double val = 0;
+	for(size_t i = 0; i < x.size(); i++)
+		val += weights[i] * x[i];
+	return val;
+}
+
+void MLMC::propensities(const std::vector<long int>& x, std::vector<double>& a){
+	for(size_t r = 0; r < rates.size(); r++)
+		a[r] = rates[r] * x[from[r]];
+}
+
+// Every path, tau-leap or exact, applies the reaction counts of a step together and clamps populations at zero once at
+// the end of the step, as in System::updateSystem. Clamping the same way on every level keeps the coarse path of a
+// coupled pair distributed exactly as the fine path of the level below, so the levels telescope.
+void MLMC::apply(std::vector<long int>& x, std::vector<long int>& counts){
+	for(size_t r = 0; r < counts.size(); r++){
+		if(counts[r] == 0)
+			continue;
+		for(size_t i = 0; i < x.size(); i++)
+			x[i] += deltas[r][i] * counts[r];
+		counts[r] = 0;
+	}
+	for(size_t i = 0; i < x.size(); i++){
+		if(x[i] < 0)
+			x[i] = 0;
+	}
+}
+
+double MLMC::tauLeap(double h){
+	std::vector<long int> x = init, counts(rates.size(), 0);
+	std::vector<double> a(rates.size());
+	for(long int k = 0; k * h < horizon; k++){
+		double dt = std::min(h, horizon - k * h);
+		propensities(x, a);
+		for(size_t r = 0; r < rates.size(); r++){
+			if(a[r] > 0)
+				counts[r] = gsl_ran_poisson(rng, a[r] * dt);
+		}
+		apply(x, counts);
+	}
+	return f(x);
+}
+
+// Fine and coarse paths share the Poisson increment of min(a_fine, a_coarse) on every fine step. The coarse counts
+// add up over the fine steps of a coarse step and are applied at its end, as tauLeap with the coarse step would.
+double MLMC::coupledTauLeap(double hf){
+	std::vector<long int> xf = init, xc = init;
+	std::vector<long int> countsFine(rates.size(), 0), countsCoarse(rates.size(), 0);
+	std::vector<double> af(rates.size()), ac(rates.size());
+	for(long int k = 0; k * hf < horizon; k++){
+		double dt = std::min(hf, horizon - k * hf);
+		if(k % refine == 0)
+			propensities(xc, ac);
+		propensities(xf, af);
+		for(size_t r = 0; r < rates.size(); r++){
+			double m = std::min(af[r], ac[r]);
+			long int shared = m > 0 ? gsl_ran_poisson(rng, m * dt) : 0;
+			countsFine[r] = shared + (af[r] > m ? gsl_ran_poisson(rng, (af[r] - m) * dt) : 0);
+			countsCoarse[r] += shared + (ac[r] > m ? gsl_ran_poisson(rng, (ac[r] - m) * dt) : 0);
+		}
+		apply(xf, countsFine);
+		if(k % refine == refine - 1 || (k + 1) * hf >= horizon)
+			apply(xc, countsCoarse);
+	}
+	return f(xf) - f(xc);
+}
+
+// Exact path and tau-leap path driven by one Gillespie clock over three channels per reaction: shared, exact-only
+// and tau-only. Tau-leap events are counted and applied at the next grid point, so the tau-leap propensities stay
+// frozen between grid points and the path is distributed as tauLeap(h). The exact path fires one event at a time.
+double MLMC::coupledExact(double h){
+	int R = rates.size();
+	std::vector<long int> xe = init, xt = init;
+	std::vector<long int> one(R, 0), countsTau(R, 0);
+	std::vector<double> ae(R), at(R), channels(3 * R);
+	double t = 0;
+	double nextGrid = 0;
+	while(true){
+		if(t >= nextGrid){
+			apply(xt, countsTau);
+			propensities(xt, at);
+			nextGrid += h;
+		}
+		propensities(xe, ae);
+		double total = 0;
+		for(int r = 0; r < R; r++){
+			double m = std::min(ae[r], at[r]);
+			channels[3*r] = m;
+			channels[3*r + 1] = ae[r] - m;
+			channels[3*r + 2] = at[r] - m;
+			total += ae[r] + at[r] - m;
+		}
+
+		double stop = std::min(nextGrid, horizon);
+		double dt = total > 0 ? gsl_ran_exponential(rng, 1 / total) : INFINITY;
+		if(t + dt >= stop){
+			// Memoryless clock: jump to the grid point and redraw with refreshed tau-leap propensities
+			t = stop;
+			if(t >= horizon){
+				apply(xt, countsTau);
+				break;
+			}
+			continue;
+		}
+		t += dt;
+
+		int c = chooseTransition(channels, total, rng);
+		int r = c / 3;
+		if(c % 3 != 2){
+			one[r] = 1;
+			apply(xe, one);
+		}
+		if(c % 3 != 1)
+			countsTau[r]++;
+	}
+	return f(xe) - f(xt);
+}
+
+double MLMC::sampleLevel(int level){
+	if(level == nlevels)
+		return coupledExact(stats[nlevels - 1].step);
+	if(level == 0)
+		return tauLeap(h0);
+	return coupledTauLeap(stats[level].step);
+}
+
+void MLMC::run(int level, long int n){
+	auto start = std::chrono::steady_clock::now();
+	for(long int i = 0; i < n; i++){
+		if((i & 0xFF) == 0)
+			Rcpp::checkUserInterrupt();
+		double y = sampleLevel(level);
+		stats[level].sum += y;
+		stats[level].sumSq += y * y;
+	}
+	stats[level].samples += n;
+	stats[level].seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Giles' allocation: N_l proportional to sqrt(V_l / C_l), scaled so that sum V_l / N_l = rmse^2. The estimator is
+// unbiased, so the whole error budget goes to variance.
+void MLMC::estimate(double rmse, long int pilot){
+	for(int l = 0; l <= nlevels; l++)
+		run(l, pilot);
+
+	while(true){
+		double s = 0;
+		for(int l = 0; l <= nlevels; l++)
+			s += std::sqrt(stats[l].variance() * stats[l].cost());
+
+		bool done = true;
+		for(int l = 0; l <= nlevels; l++){
+			double target = std::ceil(s * std::sqrt(stats[l].variance() / stats[l].cost()) / (rmse * rmse));
+			long int extra = (long int)target - stats[l].samples;
+			if(extra > 0){
+				done = false;
+				// Grow in steps so the variance and cost estimates can settle
+				run(l, std::min(extra, std::max(stats[l].samples, pilot)));
+			}
+		}
+
+		if(!silent){
+			for(int l = 0; l <= nlevels; l++)
+				std::cout << "Level " << l << ": " << stats[l].samples << " samples, variance " << stats[l].variance() << std::endl;
+		}
+		if(done)
+			break;
+	}
+}
@@ -0,0 +1,270 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  ModelFile.cpp
+ *
+ *    Description:  Simulation jobs read from plain-text model files, without R
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 16:31:08
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+#include "ModelFile.h"
+#include "ConstantRate.h"
+#include "FileInput.h"
+#include "Update.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <cctype>
+#include <iomanip>
+#include <stdint.h>
+
+ModelFile::ModelFile(std::string file) : ntype(0), reps(1), threads(1), seed(0), seeded(false), output("sims.csv"),
+	format("csv"), surrogate(0), shard(1), shards(1) {
+	std::ifstream in(file);
+	if(!in.is_open())
+		throw std::invalid_argument("Unable to open model file " + file);
+
+	std::string line;
+	int number = 0;
+	while(getline(in, line)){
+		number++;
+		size_t comment = line.find('#');
+		if(comment != std::string::npos)
+			line.erase(comment);
+		parseLine(line, number);
+	}
+
+	if(ntype <= 0)
+		throw std::invalid_argument("Model file does not give the number of types");
+	if(initial.size() != (size_t)ntype)
+		throw std::invalid_argument("Initial population does not match the number of types");
+	if(times.empty())
+		throw std::invalid_argument("Model file has no observation times");
+	for(size_t i = 1; i < times.size(); i++)
+		if(times[i] < times[i-1])
+			throw std::invalid_argument("Observation times must be increasing");
+	if(transitions.empty())
+		throw std::invalid_argument("Model file has no transitions");
+	for(size_t i = 0; i < transitions.size(); i++)
+		if(transitions[i].offspring.size() != (size_t)ntype)
+			throw std::invalid_argument("Offspring vector does not match the number of types");
+}
+
+ModelFile::~ModelFile(){
+	for(auto i = handles.begin(); i != handles.end(); i++){
+		#ifdef _WIN32
+			FreeLibrary((HINSTANCE)*i);
+		#else
+			dlclose(*i);
+		#endif
+	}
+}
+
+static std::runtime_error lineError(int number, const std::string& what){
+	return std::runtime_error("Model file line " + std::to_string(number) + ": " + what);
+}
+
+// Numbers up to the end of the stream, or the contents of @file
+static std::vector<double> readNumbers(std::istringstream& in){
+	std::string word;
+	std::vector<double> out;
+	while(in >> word){
+		if(word[0] == '@'){
+			std::vector<double> f = fileToVector(word.substr(1));
+			out.insert(out.end(), f.begin(), f.end());
+		} else {
+			out.push_back(std::stod(word));
+		}
+	}
+	return out;
+}
+
+void* ModelFile::open(const std::string& location, int number){
+	#ifdef _WIN32
+		void* hand = (void*)LoadLibrary(location.c_str());
+	#else
+		void* hand = dlopen(location.c_str(), RTLD_NOW);
+	#endif
+	if(!hand)
+		throw lineError(number, "invalid file name for custom dll");
+	handles.push_back(hand);
+	return hand;
+}
+
+void ModelFile::parseLine(const std::string& line, int number){
+	std::istringstream in(line);
+	std::string key;
+	if(!(in >> key))
+		return;
+
+	try{
+		if(key == "types"){
+			in >> ntype;
+		} else if(key == "initial"){
+			std::vector<double> x = readNumbers(in);
+			initial.assign(x.begin(), x.end());
+		} else if(key == "times"){
+			times = readNumbers(in);
+		} else if(key == "transition"){
+			ModelTransition t;
+			t.plugin = nullptr;
+			in >> t.parent;
+			t.parent--;
+			if(t.parent < 0 || (ntype > 0 && t.parent >= ntype))
+				throw lineError(number, "parent type out of range");
+
+			std::string word;
+			in >> word;
+			if(word == "linear" || word == "switch" || word == "pulse"){
+				t.kind = word;
+				size_t n = word == "linear" ? 2 : word == "switch" ? 3 : 4;
+				for(size_t i = 0; i < n && in >> word; i++)
+					t.params.push_back(std::stod(word));
+				if(t.params.size() != n)
+					throw lineError(number, "wrong number of rate parameters");
+			} else if(word == "plugin"){
+				t.kind = word;
+				in >> t.library >> t.symbol;
+				void* hand = open(t.library, number);
+				#ifdef _WIN32
+					t.plugin = (double (*)(double, void*))GetProcAddress((HINSTANCE)hand, t.symbol.c_str());
+				#else
+					t.plugin = (double (*)(double, void*))dlsym(hand, t.symbol.c_str());
+				#endif
+				if(!t.plugin)
+					throw lineError(number, "rate function not found in custom dll");
+			} else {
+				t.kind = "constant";
+				t.params.push_back(std::stod(word));
+			}
+
+			in >> word;
+			if(word != "->")
+				throw lineError(number, "expected -> before the offspring vector");
+			std::vector<double> o = readNumbers(in);
+			t.offspring.assign(o.begin(), o.end());
+			transitions.push_back(t);
+		} else if(key == "stop"){
+			std::vector<int> indices;
+			std::string word;
+			while(in >> word && isdigit(word[0]))
+				indices.push_back(std::stoi(word) - 1);
+			std::string ineq = word;
+			double value;
+			if(indices.empty() || !(in >> value))
+				throw lineError(number, "expected type indices, an inequality and a value");
+			if(ineq != "<" && ineq != ">" && ineq != "<=" && ineq != ">=")
+				throw lineError(number, "invalid inequality");
+			stops.push_back(StopCriterion(indices, ineq, value));
+		} else if(key == "reps"){
+			in >> reps;
+		} else if(key == "threads"){
+			in >> threads;
+		} else if(key == "seed"){
+			in >> seed;
+			seeded = true;
+		} else if(key == "output"){
+			in >> output;
+		} else if(key == "format"){
+			in >> format;
+			if(format != "csv" && format != "binary" && format != "summary")
+				throw lineError(number, "format must be csv, binary or summary");
+		} else if(key == "shard"){
+			in >> shard >> shards;
+			if(shards < 1 || shard < 1 || shard > shards)
+				throw lineError(number, "shard must be an index from 1 to the shard count");
+		} else if(key == "surrogate"){
+			in >> surrogate;
+		} else {
+			throw lineError(number, "unknown setting " + key);
+		}
+	}
+	catch(std::logic_error& e){
+		// std::stod and std::stoi report malformed numbers as invalid_argument or out_of_range
+		throw lineError(number, "malformed number");
+	}
+	if(in.fail() && !in.eof())
+		throw lineError(number, "malformed " + key);
+}
+
+bool ModelFile::constant() const{
+	for(size_t i = 0; i < transitions.size(); i++)
+		if(transitions[i].kind != "constant")
+			return false;
+	return true;
+}
+
+void ModelFile::build(System& sys) const{
+	bool exact = constant();
+	for(size_t i = 0; i < transitions.size(); i++){
+		const ModelTransition& t = transitions[i];
+		Update u(t.offspring);
+		if(exact){
+			sys.addUpdate(t.params[0], t.parent, u);
+			continue;
+		}
+
+		Rate* r;
+		if(t.kind == "constant")
+			r = new ConstantRate(t.params[0]);
+		else if(t.kind == "linear")
+			r = new LinearRate(t.params[0], t.params[1]);
+		else if(t.kind == "switch")
+			r = new SwitchRate(t.params[0], t.params[1], t.params[2]);
+		else if(t.kind == "pulse")
+			r = new PulseRate(t.params[0], t.params[1], t.params[2], t.params[3]);
+		else
+			r = new Rate(t.plugin);
+		sys.addUpdate(r, t.parent, u);
+	}
+	for(size_t i = 0; i < stops.size(); i++)
+		sys.addStop(stops[i]);
+}
+
+std::string ModelFile::fingerprint() const{
+	std::ostringstream s;
+	s.precision(17);
+	s << ntype << ";";
+	for(size_t i = 0; i < initial.size(); i++) s << initial[i] << ",";
+	s << ";";
+	for(size_t i = 0; i < times.size(); i++) s << times[i] << ",";
+	for(size_t i = 0; i < transitions.size(); i++){
+		const ModelTransition& t = transitions[i];
+		s << ";" << t.parent << " " << t.kind << " " << t.library << " " << t.symbol;
+		for(size_t j = 0; j < t.params.size(); j++) s << " " << t.params[j];
+		s << " ->";
+		for(size_t j = 0; j < t.offspring.size(); j++) s << " " << t.offspring[j];
+	}
+	for(size_t i = 0; i < stops.size(); i++){
+		s << ";stop";
+		for(size_t j = 0; j < stops[i].indices.size(); j++) s << " " << stops[i].indices[j];
+		s << " " << stops[i].inequality << " " << stops[i].value;
+	}
+
+	// 64-bit FNV-1a
+	uint64_t h = 14695981039346656037ULL;
+	std::string text = s.str();
+	for(size_t i = 0; i < text.size(); i++){
+		h ^= (unsigned char)text[i];
+		h *= 1099511628211ULL;
+	}
+	std::ostringstream hex;
+	hex << std::hex << std::setw(16) << std::setfill('0') << h;
+	return hex.str();
+}
@@ -0,0 +1,189 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  ModelLoader.cpp
+ *
+ *    Description:  Builds rates, transitions and stopping criteria from R lists
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 13:20:51
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+// For plugin system
+#ifndef USE_PRECOMPILED_HEADERS
+#ifdef _WIN32
+#include <direct.h>
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+#endif
+
+#include "ModelLoader.h"
+#include "ConstantRate.h"
+#include "StopCriterion.h"
+#include "Update.h"
+#include "Lifetime.h"
+
+#include <Rinternals.h>
+
+extern bool silent;
+
+PluginHandles::PluginHandles(){}
+
+PluginHandles::~PluginHandles(){
+	for(auto i = handles.begin(); i != handles.end(); i++){
+		#ifdef _WIN32
+			FreeLibrary((HINSTANCE)*i);
+		#else
+			dlclose(*i);
+		#endif
+	}
+}
+
+void* PluginHandles::open(const char* location){
+	#ifdef _WIN32
+		void* hand = (void*)LoadLibrary(location);
+	#else
+		void* hand = dlopen(location, RTLD_NOW);
+	#endif
+	if(!hand)
+	{
+		Rcpp::stop("invalid file name for custom dll");
+	}
+	handles.push_back(hand);
+	return hand;
+}
+
+Rate* loadRate(Rcpp::List transition, PluginHandles& plugins){
+	Rate* r = nullptr;
+	if(Rcpp::as<int>(transition["type"]) == 1)
+	{
+		if(!silent) std::cout << "Constant rate found!" << std::endl;
+		r = new ConstantRate(Rcpp::as<double>(transition["rate"]));
+	}
+	else if(Rcpp::as<int>(transition["type"]) == 2)
+	{
+		if(!silent) std::cout << "Variable rate found!" << std::endl;
+		Rcpp::StringVector params = Rcpp::as<Rcpp::StringVector>(transition["rate"]);
+
+		double (*rate)(double, void*);
+
+		// Name for plugin library location
+		const char* plugin_location = CHAR(Rf_asChar(params[0]));
+
+		// Load plugin library
+		void* hand = plugins.open(plugin_location);
+		#ifdef _WIN32
+			rate = (double (*)(double, void*))GetProcAddress((HINSTANCE)hand, params[1]);
+		#else
+			rate = (double (*)(double, void*))dlsym(hand, params[1]);
+		#endif
+
+		r = new Rate(rate);
+	}
+	else
+	{
+		Rcpp::stop("invalid rate selection");
+	}
+	return r;
+}
+
+int loadParent(Rcpp::List transition){
+	int population = transition["parent"];
+	return population - 1; //shift to 0-indexing
+}
+
+std::vector<int> loadOffspring(Rcpp::List transition){
+	Rcpp::NumericVector fix = Rcpp::as<Rcpp::NumericVector>(transition["offspring"]);
+	return std::vector<int>(fix.begin(), fix.end());
+}
+
+void loadTransitions(System& sys, Rcpp::List transitions, PluginHandles& plugins){
+	// Iterate over transitions list
+	for(int i = 0; i < transitions.length(); i++){
+		Rcpp::List list_i = Rcpp::as<Rcpp::List>(transitions[i]);
+		sys.addUpdate(loadRate(list_i, plugins), loadParent(list_i), Update(loadOffspring(list_i)));
+	}
+}
+
+void loadConstantTransitions(System& sys, Rcpp::List transitions){
+	// Iterate over transitions list
+	for(int i = 0; i < transitions.length(); i++){
+		Rcpp::List list_i = Rcpp::as<Rcpp::List>(transitions[i]);
+		double rate = list_i["rate"];
+		sys.addUpdate(rate, loadParent(list_i), Update(loadOffspring(list_i)));
+	}
+}
+
+StopCriterion loadStop(Rcpp::List stop){
+	// Get the indices to combine, inequality for comparison, and value to compare against
+	Rcpp::NumericVector ind = Rcpp::as<Rcpp::NumericVector>(stop[0]);
+	std::vector<int> indices (ind.begin(), ind.end());
+
+	std::string ineq = stop[1];
+	double value = stop[2];
+
+	return StopCriterion(indices, ineq, value);
+}
+
+void loadStops(System& sys, Rcpp::List stops){
+	// Iterate over StopCriterionList list
+	for(int i = 0; i < stops.length(); i++){
+		sys.addStop(loadStop(Rcpp::as<Rcpp::List>(stops[i])));
+	}
+}
+
+void loadLifetimes(System& sys, Rcpp::List lifetimes){
+	for(int i = 0; i < lifetimes.length(); i++){
+		Rcpp::List list_i = Rcpp::as<Rcpp::List>(lifetimes[i]);
+		std::string dist = list_i["dist"];
+		Rcpp::NumericVector p = Rcpp::as<Rcpp::NumericVector>(list_i["params"]);
+		sys.addLifetime(Lifetime(dist, std::vector<double>(p.begin(), p.end())));
+	}
+}
+
+Expression loadExpression(Rcpp::List transition){
+	Rcpp::NumericVector ops = Rcpp::as<Rcpp::NumericVector>(transition["ops"]);
+	Rcpp::NumericVector values = Rcpp::as<Rcpp::NumericVector>(transition["values"]);
+	return Expression(std::vector<int>(ops.begin(), ops.end()), std::vector<double>(values.begin(), values.end()));
+}
+
+Emission loadEmission(Rcpp::List emission, PluginHandles& plugins){
+	std::string dist = emission["dist"];
+	Rcpp::NumericVector p = Rcpp::as<Rcpp::NumericVector>(emission["params"]);
+
+	EmissionFunction f = nullptr;
+	if(dist == "custom"){
+		const char* library = CHAR(Rf_asChar(emission["library"]));
+		const char* symbol = CHAR(Rf_asChar(emission["symbol"]));
+		void* hand = plugins.open(library);
+		#ifdef _WIN32
+			f = (EmissionFunction)GetProcAddress((HINSTANCE)hand, symbol);
+		#else
+			f = (EmissionFunction)dlsym(hand, symbol);
+		#endif
+		if(!f)
+			Rcpp::stop("emission density not found in custom dll");
+	}
+	return Emission(dist, std::vector<double>(p.begin(), p.end()), f);
+}
+
+void loadSparseRules(SparseSystem& sys, Rcpp::List rules){
+	for(int i = 0; i < rules.length(); i++){
+		Rcpp::List list_i = Rcpp::as<Rcpp::List>(rules[i]);
+		SparseRule r;
+		r.rate = Rcpp::as<double>(list_i["rate"]);
+		r.same = Rcpp::as<int>(list_i["same"]);
+		r.mutant = Rcpp::as<int>(list_i["mutant"]);
+		r.mutation = Rcpp::as<int>(list_i["mutation"]);
+		sys.addRule(r);
+	}
+}
@@ -0,0 +1,188 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  ParticleFilter.cpp
+ *
+ *    Description:  Bootstrap particle filter for longitudinal count data
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 17:02:18
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+
+#include "ParticleFilter.h"
+#include "helpers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <gsl/gsl_randist.h>
+
+#include <Rcpp.h>
+
+ParticleFilter::ParticleFilter(System& sys, std::vector<Emission> e, double threshold)
+	: rates(sys.rates), from(sys.from), ntype(sys.state.size()), emissions(e), leapThreshold(threshold), leapEps(0.03), leaps(0){
+	if(emissions.size() != (size_t)ntype)
+		throw std::invalid_argument("Need one emission distribution per type");
+	deltas = transitionDeltas(sys.updates, from);
+}
+
+ParticleFilter::~ParticleFilter(){}
+
+// Advance one particle by dt; returns the number of tau-leaps taken
+long int ParticleFilter::propagate(long int* x, double dt, std::vector<double>& a, gsl_rng* r) const{
+	int nrate = rates.size();
+	long int nleap = 0;
+	double t = 0;
+
+	while(t < dt){
+		double total = 0;
+		bool leap = true;
+		for(int j = 0; j < nrate; j++){
+			a[j] = rates[j] * x[from[j]];
+			total += a[j];
+			if(a[j] > 0 && x[from[j]] < leapThreshold)
+				leap = false;
+		}
+		if(total <= 0)
+			break;
+
+		if(leap){
+			// Largest step keeping every shrinking or growing type's expected change within leapEps of its size
+			double tau = dt - t;
+			for(int i = 0; i < ntype; i++){
+				double drift = 0;
+				for(int j = 0; j < nrate; j++)
+					drift += a[j] * std::abs(deltas[j][i]);
+				if(drift > 0 && x[i] > 0)
+					tau = std::min(tau, leapEps * x[i] / drift);
+			}
+			for(int j = 0; j < nrate; j++){
+				if(a[j] <= 0)
+					continue;
+				long int k = gsl_ran_poisson(r, a[j] * tau);
+				for(int i = 0; i < ntype; i++)
+					x[i] += k * deltas[j][i];
+			}
+			for(int i = 0; i < ntype; i++)
+				if(x[i] < 0)
+					x[i] = 0;
+			t += tau;
+			nleap++;
+			continue;
+		}
+
+		t += gsl_ran_exponential(r, 1 / total);
+		if(t > dt)
+			break;
+
+		int j = chooseTransition(a, total, r);
+		for(int i = 0; i < ntype; i++){
+			x[i] += deltas[j][i];
+			if(x[i] < 0)
+				x[i] = 0;
+		}
+	}
+	return nleap;
+}
+
+double ParticleFilter::logWeight(const long int* x, const double* y) const{
+	double lw = 0;
+	for(int i = 0; i < ntype; i++){
+		if(!std::isnan(y[i]))
+			lw += emissions[i].logDensity(y[i], x[i]);
+	}
+	return lw;
+}
+
+double ParticleFilter::logLikelihood(const std::vector<long int>& init, const std::vector<double>& times, const std::vector<double>& observed,
+                                     int nparticles, double essThreshold, int threads, unsigned long int seed){
+	const double impossible = -std::numeric_limits<double>::infinity();
+	int nobs = times.size();
+	ThreadRngs rngs(threads);
+
+	std::vector<long int> x(nparticles * ntype), next(nparticles * ntype);
+	for(int p = 0; p < nparticles; p++)
+		std::copy(init.begin(), init.end(), x.begin() + p * ntype);
+	std::vector<double> logw(nparticles, -log((double)nparticles)), lg(nparticles);
+	std::vector<std::vector<double> > buffers(threads, std::vector<double>(rates.size()));
+
+	ess.clear();
+	increments.clear();
+	resampled.clear();
+	leaps = 0;
+
+	double loglik = 0;
+	double prev = 0;
+	for(int k = 0; k < nobs; k++){
+		double dt = times[k] - prev;
+		prev = times[k];
+		const double* y = &observed[k * ntype];
+
+		// Each particle draws from its own stream, so the estimate does not depend on the number of threads
+		long int stepLeaps = 0;
+		#pragma omp parallel for num_threads(threads) schedule(dynamic, 16) reduction(+:stepLeaps)
+		for(int p = 0; p < nparticles; p++){
+			int tid = threadIndex();
+			gsl_rng* r = rngs.rngs[tid];
+			seedStream(r, seed, k, p);
+			stepLeaps += propagate(&x[p * ntype], dt, buffers[tid], r);
+			lg[p] = logWeight(&x[p * ntype], y);
+		}
+		leaps += stepLeaps;
+		Rcpp::checkUserInterrupt();
+
+		// log sum_p W_p g(y | x_p), with W the normalized weights carried into this step
+		double m = impossible;
+		for(int p = 0; p < nparticles; p++)
+			m = std::max(m, logw[p] + lg[p]);
+		if(m == impossible){
+			increments.push_back(impossible);
+			ess.push_back(0);
+			resampled.push_back(0);
+			return impossible;
+		}
+		double s = 0;
+		for(int p = 0; p < nparticles; p++)
+			s += exp(logw[p] + lg[p] - m);
+		double inc = m + log(s);
+		loglik += inc;
+		increments.push_back(inc);
+
+		double sumSq = 0;
+		for(int p = 0; p < nparticles; p++){
+			logw[p] += lg[p] - inc;
+			sumSq += exp(2 * logw[p]);
+		}
+		ess.push_back(1 / sumSq);
+
+		// Systematic resampling: one uniform, nparticles evenly spaced points through the cumulative weights
+		if(ess.back() < essThreshold * nparticles){
+			gsl_rng* r = rngs.rngs[0];
+			seedStream(r, seed, k, nparticles);
+			double u = gsl_rng_uniform(r) / nparticles;
+			double cum = exp(logw[0]);
+			int src = 0;
+			for(int p = 0; p < nparticles; p++){
+				double point = u + (double)p / nparticles;
+				while(cum < point && src < nparticles - 1)
+					cum += exp(logw[++src]);
+				std::copy(x.begin() + src * ntype, x.begin() + (src + 1) * ntype, next.begin() + p * ntype);
+			}
+			x.swap(next);
+			std::fill(logw.begin(), logw.end(), -log((double)nparticles));
+			resampled.push_back(1);
+		} else {
+			resampled.push_back(0);
+		}
+	}
+	return loglik;
+}
@@ -0,0 +1,174 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Propagator.cpp
+ *
+ *    Description:  Composition of moment propagators over adjacent time segments
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 11:02:15
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "Propagator.h"
+
+#include <algorithm>
+#include <map>
+
+#include <Rcpp.h>
+
+int propagatorWidth(int ntype, int nparam){
+	return (ntype*ntype + ntype*ntype*ntype) * (nparam + 1);
+}
+
+void identityPropagator(double* out, int ntype, int nparam){
+	int n = ntype;
+	std::fill(out, out + propagatorWidth(n, nparam), 0.0);
+	for(int i = 0; i < n; ++i){
+		out[i + n*i] = 1;
+		out[n*n + i + n*(i + n*i)] = 1;
+	}
+}
+
+// out[k, i] += sum_l a[k, l] b[l, i]
+static void addMeanProduct(const double* a, const double* b, double* out, int n){
+	for(int i = 0; i < n; ++i)
+		for(int l = 0; l < n; ++l)
+			for(int k = 0; k < n; ++k)
+				out[k + n*i] += a[k + n*l] * b[l + n*i];
+}
+
+// out[k, i, j] += sum_l m[k, l] v[l, i, j]
+static void addSecondProduct(const double* m, const double* v, double* out, int n){
+	for(int ij = 0; ij < n*n; ++ij)
+		for(int l = 0; l < n; ++l)
+			for(int k = 0; k < n; ++k)
+				out[k + n*ij] += m[k + n*l] * v[l + n*ij];
+}
+
+// out[k, i, j] += sum_{l, m} d[k, l, m] x[l, i] y[m, j], done in two O(n^4) passes
+static void addQuadratic(const double* d, const double* x, const double* y, double* out, int n, std::vector<double>& tmp){
+	tmp.assign(n*n*n, 0.0);
+	for(int j = 0; j < n; ++j)
+		for(int m = 0; m < n; ++m)
+			for(int l = 0; l < n; ++l)
+				for(int k = 0; k < n; ++k)
+					tmp[k + n*(l + n*j)] += d[k + n*(l + n*m)] * y[m + n*j];
+
+	for(int j = 0; j < n; ++j)
+		for(int i = 0; i < n; ++i)
+			for(int l = 0; l < n; ++l)
+				for(int k = 0; k < n; ++k)
+					out[k + n*(i + n*j)] += tmp[k + n*(l + n*j)] * x[l + n*i];
+}
+
+void composePropagators(const double* first, const double* second, double* out, int ntype, int nparam){
+	int n = ntype;
+	int block = n*n + n*n*n;
+	std::fill(out, out + propagatorWidth(n, nparam), 0.0);
+
+	const double* m1 = first;
+	const double* d1 = first + n*n;
+	const double* m2 = second;
+	const double* d2 = second + n*n;
+
+	// Z(u) is a sum of independent copies started by the population at t, so conditioning on Z(t) gives
+	// M(s,u) = M(s,t) M(t,u) and D(s,u) = M(s,t) V(t,u) + D(s,t)[M(t,u), M(t,u)], where V is the one-ancestor covariance
+	std::vector<double> v2(n*n*n), tmp;
+	for(int j = 0; j < n; ++j)
+		for(int i = 0; i < n; ++i)
+			for(int l = 0; l < n; ++l)
+				v2[l + n*(i + n*j)] = d2[l + n*(i + n*j)] - m2[l + n*i] * m2[l + n*j];
+
+	addMeanProduct(m1, m2, out, n);
+	addSecondProduct(m1, v2.data(), out + n*n, n);
+	addQuadratic(d1, m2, m2, out + n*n, n, tmp);
+
+	// Product rule for the parameter sensitivities
+	std::vector<double> dv2(n*n*n);
+	for(int p = 1; p <= nparam; ++p){
+		const double* dm1 = first + block*p;
+		const double* dd1 = dm1 + n*n;
+		const double* dm2 = second + block*p;
+		const double* dd2 = dm2 + n*n;
+		double* dm = out + block*p;
+		double* dd = dm + n*n;
+
+		for(int j = 0; j < n; ++j)
+			for(int i = 0; i < n; ++i)
+				for(int l = 0; l < n; ++l)
+					dv2[l + n*(i + n*j)] = dd2[l + n*(i + n*j)] - dm2[l + n*i] * m2[l + n*j] - m2[l + n*i] * dm2[l + n*j];
+
+		addMeanProduct(dm1, m2, dm, n);
+		addMeanProduct(m1, dm2, dm, n);
+
+		addSecondProduct(dm1, v2.data(), dd, n);
+		addSecondProduct(m1, dv2.data(), dd, n);
+		addQuadratic(dd1, m2, m2, dd, n, tmp);
+		addQuadratic(d1, dm2, m2, dd, n, tmp);
+		addQuadratic(d1, m2, dm2, dd, n, tmp);
+	}
+}
+
+// [[Rcpp::export]]
+Rcpp::NumericMatrix composeMoments(Rcpp::NumericMatrix segments, Rcpp::NumericVector grid, Rcpp::NumericVector start_times, Rcpp::NumericVector end_times, int ntype, int nparam){
+	int width = propagatorWidth(ntype, nparam);
+	int nobs = start_times.size();
+
+	// segments row a holds the propagator over [grid[a], grid[a+1]]
+	std::map<double, int> gridIndex;
+	for(int a = 0; a < grid.size(); ++a)
+		gridIndex[grid[a]] = a;
+
+	std::vector<double> seg(segments.nrow() * (size_t)width);
+	for(int a = 0; a < segments.nrow(); ++a)
+		for(int c = 0; c < width; ++c)
+			seg[(size_t)a*width + c] = segments(a, c);
+
+	// Unique ends in order of appearance, each with the set of grid points it starts from
+	std::vector<double> ends;
+	std::map<double, std::vector<bool> > starts;
+	for(int obs = 0; obs < nobs; ++obs){
+		if(starts.find(end_times[obs]) == starts.end()){
+			ends.push_back(end_times[obs]);
+			starts[end_times[obs]] = std::vector<bool>(grid.size(), false);
+		}
+		starts[end_times[obs]][gridIndex[start_times[obs]]] = true;
+	}
+
+	std::vector<std::vector<double> > rows;
+	std::vector<double> acc(width), next(width);
+	for(size_t e = 0; e < ends.size(); ++e){
+		int b = gridIndex[ends[e]];
+		std::vector<bool>& from = starts[ends[e]];
+		int earliest = std::find(from.begin(), from.end(), true) - from.begin();
+
+		// Walk backward from the end time to its earliest start, prepending one segment at a time
+		identityPropagator(acc.data(), ntype, nparam);
+		for(int a = b; a >= earliest; --a){
+			if(a < b){
+				composePropagators(&seg[(size_t)a*width], acc.data(), next.data(), ntype, nparam);
+				acc.swap(next);
+			}
+			if(from[a]){
+				std::vector<double> row(width + 2);
+				row[0] = ends[e];
+				row[1] = ends[e] - grid[a];
+				std::copy(acc.begin(), acc.end(), row.begin() + 2);
+				rows.push_back(row);
+			}
+		}
+	}
+
+	Rcpp::NumericMatrix out(rows.size(), width + 2);
+	for(size_t r = 0; r < rows.size(); ++r)
+		for(int c = 0; c < width + 2; ++c)
+			out(r, c) = rows[r][c];
+	return out;
+}
@@ -45,3 +45,10 @@ double Rate::operator()(double time){
 	return std::max(0.0, GSL_FN_EVAL(&funct, time));
 }
 
+void Rate::fillMajorant(double start_time, double end_time, int bins, std::vector<double>& maxes, double buffer){
+	maximizePiecewise(funct, start_time, end_time, bins, maxes, buffer);
+}
+
+double Rate::period(){
+	return 0;
+}
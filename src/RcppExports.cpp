@@ -7,8 +7,8 @@
 using namespace Rcpp;
 
 // gmbp3
-double gmbp3(Rcpp::NumericVector observations, int reps, std::string file, Rcpp::NumericVector initial, Rcpp::List transitions, Rcpp::List stops, bool silence, SEXP seed);
-RcppExport SEXP _estipop_gmbp3(SEXP observationsSEXP, SEXP repsSEXP, SEXP fileSEXP, SEXP initialSEXP, SEXP transitionsSEXP, SEXP stopsSEXP, SEXP silenceSEXP, SEXP seedSEXP) {
+Rcpp::List gmbp3(Rcpp::NumericVector observations, int reps, std::string file, Rcpp::NumericVector initial, Rcpp::List transitions, Rcpp::List stops, bool silence, SEXP seed, std::string checkpoint, double checkpoint_every, bool resume);
+RcppExport SEXP _estipop_gmbp3(SEXP observationsSEXP, SEXP repsSEXP, SEXP fileSEXP, SEXP initialSEXP, SEXP transitionsSEXP, SEXP stopsSEXP, SEXP silenceSEXP, SEXP seedSEXP, SEXP checkpointSEXP, SEXP checkpoint_everySEXP, SEXP resumeSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -20,13 +20,16 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< Rcpp::List >::type stops(stopsSEXP);
     Rcpp::traits::input_parameter< bool >::type silence(silenceSEXP);
     Rcpp::traits::input_parameter< SEXP >::type seed(seedSEXP);
-    rcpp_result_gen = Rcpp::wrap(gmbp3(observations, reps, file, initial, transitions, stops, silence, seed));
+    Rcpp::traits::input_parameter< std::string >::type checkpoint(checkpointSEXP);
+    Rcpp::traits::input_parameter< double >::type checkpoint_every(checkpoint_everySEXP);
+    Rcpp::traits::input_parameter< bool >::type resume(resumeSEXP);
+    rcpp_result_gen = Rcpp::wrap(gmbp3(observations, reps, file, initial, transitions, stops, silence, seed, checkpoint, checkpoint_every, resume));
     return rcpp_result_gen;
 END_RCPP
 }
 // timeDepBranch
-double timeDepBranch(Rcpp::NumericVector observations, int reps, std::string file, Rcpp::NumericVector initial, Rcpp::List transitions, Rcpp::List stops, bool silence, SEXP seed);
-RcppExport SEXP _estipop_timeDepBranch(SEXP observationsSEXP, SEXP repsSEXP, SEXP fileSEXP, SEXP initialSEXP, SEXP transitionsSEXP, SEXP stopsSEXP, SEXP silenceSEXP, SEXP seedSEXP) {
+Rcpp::List timeDepBranch(Rcpp::NumericVector observations, int reps, std::string file, Rcpp::NumericVector initial, Rcpp::List transitions, Rcpp::List stops, bool silence, SEXP seed, double surrogate, std::string checkpoint, double checkpoint_every, bool resume);
+RcppExport SEXP _estipop_timeDepBranch(SEXP observationsSEXP, SEXP repsSEXP, SEXP fileSEXP, SEXP initialSEXP, SEXP transitionsSEXP, SEXP stopsSEXP, SEXP silenceSEXP, SEXP seedSEXP, SEXP surrogateSEXP, SEXP checkpointSEXP, SEXP checkpoint_everySEXP, SEXP resumeSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -38,14 +41,350 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< Rcpp::List >::type stops(stopsSEXP);
     Rcpp::traits::input_parameter< bool >::type silence(silenceSEXP);
     Rcpp::traits::input_parameter< SEXP >::type seed(seedSEXP);
-    rcpp_result_gen = Rcpp::wrap(timeDepBranch(observations, reps, file, initial, transitions, stops, silence, seed));
+    Rcpp::traits::input_parameter< double >::type surrogate(surrogateSEXP);
+    Rcpp::traits::input_parameter< std::string >::type checkpoint(checkpointSEXP);
+    Rcpp::traits::input_parameter< double >::type checkpoint_every(checkpoint_everySEXP);
+    Rcpp::traits::input_parameter< bool >::type resume(resumeSEXP);
+    rcpp_result_gen = Rcpp::wrap(timeDepBranch(observations, reps, file, initial, transitions, stops, silence, seed, surrogate, checkpoint, checkpoint_every, resume));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ageDepBranch
+double ageDepBranch(Rcpp::NumericVector observations, int reps, std::string file, Rcpp::NumericVector initial, Rcpp::List transitions, Rcpp::List lifetimes, Rcpp::List stops, bool silence, SEXP seed);
+RcppExport SEXP _estipop_ageDepBranch(SEXP observationsSEXP, SEXP repsSEXP, SEXP fileSEXP, SEXP initialSEXP, SEXP transitionsSEXP, SEXP lifetimesSEXP, SEXP stopsSEXP, SEXP silenceSEXP, SEXP seedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type observations(observationsSEXP);
+    Rcpp::traits::input_parameter< int >::type reps(repsSEXP);
+    Rcpp::traits::input_parameter< std::string >::type file(fileSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type initial(initialSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type transitions(transitionsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type lifetimes(lifetimesSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type stops(stopsSEXP);
+    Rcpp::traits::input_parameter< bool >::type silence(silenceSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type seed(seedSEXP);
+    rcpp_result_gen = Rcpp::wrap(ageDepBranch(observations, reps, file, initial, transitions, lifetimes, stops, silence, seed));
+    return rcpp_result_gen;
+END_RCPP
+}
+// sparseBranch
+Rcpp::List sparseBranch(Rcpp::NumericVector observations, int reps, std::string file, Rcpp::NumericVector initial_ids, Rcpp::NumericVector initial_counts, Rcpp::List rules, bool silence, SEXP seed, bool lineage);
+RcppExport SEXP _estipop_sparseBranch(SEXP observationsSEXP, SEXP repsSEXP, SEXP fileSEXP, SEXP initial_idsSEXP, SEXP initial_countsSEXP, SEXP rulesSEXP, SEXP silenceSEXP, SEXP seedSEXP, SEXP lineageSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type observations(observationsSEXP);
+    Rcpp::traits::input_parameter< int >::type reps(repsSEXP);
+    Rcpp::traits::input_parameter< std::string >::type file(fileSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type initial_ids(initial_idsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type initial_counts(initial_countsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type rules(rulesSEXP);
+    Rcpp::traits::input_parameter< bool >::type silence(silenceSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< bool >::type lineage(lineageSEXP);
+    rcpp_result_gen = Rcpp::wrap(sparseBranch(observations, reps, file, initial_ids, initial_counts, rules, silence, seed, lineage));
+    return rcpp_result_gen;
+END_RCPP
+}
+// splitBranch
+Rcpp::List splitBranch(Rcpp::NumericVector initial, Rcpp::List transitions, Rcpp::List target, Rcpp::NumericVector levels, double horizon, int effort, double budget, int max_reps, bool silence, SEXP seed);
+RcppExport SEXP _estipop_splitBranch(SEXP initialSEXP, SEXP transitionsSEXP, SEXP targetSEXP, SEXP levelsSEXP, SEXP horizonSEXP, SEXP effortSEXP, SEXP budgetSEXP, SEXP max_repsSEXP, SEXP silenceSEXP, SEXP seedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type initial(initialSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type transitions(transitionsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type target(targetSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type levels(levelsSEXP);
+    Rcpp::traits::input_parameter< double >::type horizon(horizonSEXP);
+    Rcpp::traits::input_parameter< int >::type effort(effortSEXP);
+    Rcpp::traits::input_parameter< double >::type budget(budgetSEXP);
+    Rcpp::traits::input_parameter< int >::type max_reps(max_repsSEXP);
+    Rcpp::traits::input_parameter< bool >::type silence(silenceSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type seed(seedSEXP);
+    rcpp_result_gen = Rcpp::wrap(splitBranch(initial, transitions, target, levels, horizon, effort, budget, max_reps, silence, seed));
+    return rcpp_result_gen;
+END_RCPP
+}
+// mlmcBranch
+Rcpp::List mlmcBranch(Rcpp::NumericVector initial, Rcpp::List transitions, double horizon, Rcpp::NumericVector weights, bool extinct, double h0, int refine, int nlevels, double rmse, int pilot, bool silence, SEXP seed);
+RcppExport SEXP _estipop_mlmcBranch(SEXP initialSEXP, SEXP transitionsSEXP, SEXP horizonSEXP, SEXP weightsSEXP, SEXP extinctSEXP, SEXP h0SEXP, SEXP refineSEXP, SEXP nlevelsSEXP, SEXP rmseSEXP, SEXP pilotSEXP, SEXP silenceSEXP, SEXP seedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type initial(initialSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type transitions(transitionsSEXP);
+    Rcpp::traits::input_parameter< double >::type horizon(horizonSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type weights(weightsSEXP);
+    Rcpp::traits::input_parameter< bool >::type extinct(extinctSEXP);
+    Rcpp::traits::input_parameter< double >::type h0(h0SEXP);
+    Rcpp::traits::input_parameter< int >::type refine(refineSEXP);
+    Rcpp::traits::input_parameter< int >::type nlevels(nlevelsSEXP);
+    Rcpp::traits::input_parameter< double >::type rmse(rmseSEXP);
+    Rcpp::traits::input_parameter< int >::type pilot(pilotSEXP);
+    Rcpp::traits::input_parameter< bool >::type silence(silenceSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type seed(seedSEXP);
+    rcpp_result_gen = Rcpp::wrap(mlmcBranch(initial, transitions, horizon, weights, extinct, h0, refine, nlevels, rmse, pilot, silence, seed));
+    return rcpp_result_gen;
+END_RCPP
+}
+// langevinBranch
+double langevinBranch(Rcpp::NumericVector observations, int reps, std::string file, Rcpp::NumericVector initial, Rcpp::List transitions, Rcpp::List stops, double dt, int block, bool silence, SEXP seed);
+RcppExport SEXP _estipop_langevinBranch(SEXP observationsSEXP, SEXP repsSEXP, SEXP fileSEXP, SEXP initialSEXP, SEXP transitionsSEXP, SEXP stopsSEXP, SEXP dtSEXP, SEXP blockSEXP, SEXP silenceSEXP, SEXP seedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type observations(observationsSEXP);
+    Rcpp::traits::input_parameter< int >::type reps(repsSEXP);
+    Rcpp::traits::input_parameter< std::string >::type file(fileSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type initial(initialSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type transitions(transitionsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type stops(stopsSEXP);
+    Rcpp::traits::input_parameter< double >::type dt(dtSEXP);
+    Rcpp::traits::input_parameter< int >::type block(blockSEXP);
+    Rcpp::traits::input_parameter< bool >::type silence(silenceSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type seed(seedSEXP);
+    rcpp_result_gen = Rcpp::wrap(langevinBranch(observations, reps, file, initial, transitions, stops, dt, block, silence, seed));
+    return rcpp_result_gen;
+END_RCPP
+}
+// lockstepBranch
+double lockstepBranch(Rcpp::NumericVector observations, int reps, std::string file, Rcpp::NumericVector initial, Rcpp::List transitions, Rcpp::List stops, int lanes, bool silence, SEXP seed);
+RcppExport SEXP _estipop_lockstepBranch(SEXP observationsSEXP, SEXP repsSEXP, SEXP fileSEXP, SEXP initialSEXP, SEXP transitionsSEXP, SEXP stopsSEXP, SEXP lanesSEXP, SEXP silenceSEXP, SEXP seedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type observations(observationsSEXP);
+    Rcpp::traits::input_parameter< int >::type reps(repsSEXP);
+    Rcpp::traits::input_parameter< std::string >::type file(fileSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type initial(initialSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type transitions(transitionsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type stops(stopsSEXP);
+    Rcpp::traits::input_parameter< int >::type lanes(lanesSEXP);
+    Rcpp::traits::input_parameter< bool >::type silence(silenceSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type seed(seedSEXP);
+    rcpp_result_gen = Rcpp::wrap(lockstepBranch(observations, reps, file, initial, transitions, stops, lanes, silence, seed));
+    return rcpp_result_gen;
+END_RCPP
+}
+// abcSmc
+Rcpp::List abcSmc(Rcpp::List transitions, int ntype, Rcpp::NumericMatrix init_pop, Rcpp::NumericMatrix final_pop, Rcpp::NumericVector durations, Rcpp::NumericVector lower, Rcpp::NumericVector upper, int particles, int generations, double quantile, double max_proposals, double max_events, int threads, bool silence, SEXP seed);
+RcppExport SEXP _estipop_abcSmc(SEXP transitionsSEXP, SEXP ntypeSEXP, SEXP init_popSEXP, SEXP final_popSEXP, SEXP durationsSEXP, SEXP lowerSEXP, SEXP upperSEXP, SEXP particlesSEXP, SEXP generationsSEXP, SEXP quantileSEXP, SEXP max_proposalsSEXP, SEXP max_eventsSEXP, SEXP threadsSEXP, SEXP silenceSEXP, SEXP seedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type transitions(transitionsSEXP);
+    Rcpp::traits::input_parameter< int >::type ntype(ntypeSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type init_pop(init_popSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type final_pop(final_popSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type durations(durationsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type lower(lowerSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type upper(upperSEXP);
+    Rcpp::traits::input_parameter< int >::type particles(particlesSEXP);
+    Rcpp::traits::input_parameter< int >::type generations(generationsSEXP);
+    Rcpp::traits::input_parameter< double >::type quantile(quantileSEXP);
+    Rcpp::traits::input_parameter< double >::type max_proposals(max_proposalsSEXP);
+    Rcpp::traits::input_parameter< double >::type max_events(max_eventsSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type silence(silenceSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type seed(seedSEXP);
+    rcpp_result_gen = Rcpp::wrap(abcSmc(transitions, ntype, init_pop, final_pop, durations, lower, upper, particles, generations, quantile, max_proposals, max_events, threads, silence, seed));
+    return rcpp_result_gen;
+END_RCPP
+}
+// particleFilter
+Rcpp::List particleFilter(Rcpp::NumericVector initial, Rcpp::List transitions, Rcpp::NumericVector times, Rcpp::NumericMatrix observed, Rcpp::List emissions, int particles, double ess_threshold, double leap_threshold, int threads, bool silence, SEXP seed);
+RcppExport SEXP _estipop_particleFilter(SEXP initialSEXP, SEXP transitionsSEXP, SEXP timesSEXP, SEXP observedSEXP, SEXP emissionsSEXP, SEXP particlesSEXP, SEXP ess_thresholdSEXP, SEXP leap_thresholdSEXP, SEXP threadsSEXP, SEXP silenceSEXP, SEXP seedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type initial(initialSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type transitions(transitionsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type times(timesSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type observed(observedSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type emissions(emissionsSEXP);
+    Rcpp::traits::input_parameter< int >::type particles(particlesSEXP);
+    Rcpp::traits::input_parameter< double >::type ess_threshold(ess_thresholdSEXP);
+    Rcpp::traits::input_parameter< double >::type leap_threshold(leap_thresholdSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type silence(silenceSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type seed(seedSEXP);
+    rcpp_result_gen = Rcpp::wrap(particleFilter(initial, transitions, times, observed, emissions, particles, ess_threshold, leap_threshold, threads, silence, seed));
+    return rcpp_result_gen;
+END_RCPP
+}
+// sensitivityBranch
+Rcpp::List sensitivityBranch(Rcpp::NumericVector observations, int reps, Rcpp::NumericVector initial, Rcpp::List transitions, Rcpp::NumericMatrix perturbed, Rcpp::NumericMatrix jacobian, bool crn, bool lr, int threads, bool silence, SEXP seed);
+RcppExport SEXP _estipop_sensitivityBranch(SEXP observationsSEXP, SEXP repsSEXP, SEXP initialSEXP, SEXP transitionsSEXP, SEXP perturbedSEXP, SEXP jacobianSEXP, SEXP crnSEXP, SEXP lrSEXP, SEXP threadsSEXP, SEXP silenceSEXP, SEXP seedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type observations(observationsSEXP);
+    Rcpp::traits::input_parameter< int >::type reps(repsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type initial(initialSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type transitions(transitionsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type perturbed(perturbedSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type jacobian(jacobianSEXP);
+    Rcpp::traits::input_parameter< bool >::type crn(crnSEXP);
+    Rcpp::traits::input_parameter< bool >::type lr(lrSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type silence(silenceSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type seed(seedSEXP);
+    rcpp_result_gen = Rcpp::wrap(sensitivityBranch(observations, reps, initial, transitions, perturbed, jacobian, crn, lr, threads, silence, seed));
+    return rcpp_result_gen;
+END_RCPP
+}
+// superpositionLibrary
+Rcpp::List superpositionLibrary(Rcpp::NumericVector observations, int ntype, Rcpp::List transitions, int size, int threads, bool silence, SEXP seed);
+RcppExport SEXP _estipop_superpositionLibrary(SEXP observationsSEXP, SEXP ntypeSEXP, SEXP transitionsSEXP, SEXP sizeSEXP, SEXP threadsSEXP, SEXP silenceSEXP, SEXP seedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type observations(observationsSEXP);
+    Rcpp::traits::input_parameter< int >::type ntype(ntypeSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type transitions(transitionsSEXP);
+    Rcpp::traits::input_parameter< int >::type size(sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type silence(silenceSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type seed(seedSEXP);
+    rcpp_result_gen = Rcpp::wrap(superpositionLibrary(observations, ntype, transitions, size, threads, silence, seed));
+    return rcpp_result_gen;
+END_RCPP
+}
+// superposeBranch
+Rcpp::NumericMatrix superposeBranch(Rcpp::NumericVector observations, Rcpp::List library, Rcpp::NumericMatrix initial, int reps, double clt_threshold, bool silence, SEXP seed);
+RcppExport SEXP _estipop_superposeBranch(SEXP observationsSEXP, SEXP librarySEXP, SEXP initialSEXP, SEXP repsSEXP, SEXP clt_thresholdSEXP, SEXP silenceSEXP, SEXP seedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type observations(observationsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type library(librarySEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type initial(initialSEXP);
+    Rcpp::traits::input_parameter< int >::type reps(repsSEXP);
+    Rcpp::traits::input_parameter< double >::type clt_threshold(clt_thresholdSEXP);
+    Rcpp::traits::input_parameter< bool >::type silence(silenceSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type seed(seedSEXP);
+    rcpp_result_gen = Rcpp::wrap(superposeBranch(observations, library, initial, reps, clt_threshold, silence, seed));
+    return rcpp_result_gen;
+END_RCPP
+}
+// birthDeathBranch
+double birthDeathBranch(Rcpp::NumericVector observations, int reps, std::string file, double initial, Rcpp::NumericVector breaks, Rcpp::NumericVector birth, Rcpp::NumericVector death, bool silence, SEXP seed);
+RcppExport SEXP _estipop_birthDeathBranch(SEXP observationsSEXP, SEXP repsSEXP, SEXP fileSEXP, SEXP initialSEXP, SEXP breaksSEXP, SEXP birthSEXP, SEXP deathSEXP, SEXP silenceSEXP, SEXP seedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type observations(observationsSEXP);
+    Rcpp::traits::input_parameter< int >::type reps(repsSEXP);
+    Rcpp::traits::input_parameter< std::string >::type file(fileSEXP);
+    Rcpp::traits::input_parameter< double >::type initial(initialSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type breaks(breaksSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type birth(birthSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type death(deathSEXP);
+    Rcpp::traits::input_parameter< bool >::type silence(silenceSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type seed(seedSEXP);
+    rcpp_result_gen = Rcpp::wrap(birthDeathBranch(observations, reps, file, initial, breaks, birth, death, silence, seed));
+    return rcpp_result_gen;
+END_RCPP
+}
+// extinctionProb
+Rcpp::NumericMatrix extinctionProb(Rcpp::NumericVector observations, int ntype, Rcpp::List transitions, bool silence);
+RcppExport SEXP _estipop_extinctionProb(SEXP observationsSEXP, SEXP ntypeSEXP, SEXP transitionsSEXP, SEXP silenceSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type observations(observationsSEXP);
+    Rcpp::traits::input_parameter< int >::type ntype(ntypeSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type transitions(transitionsSEXP);
+    Rcpp::traits::input_parameter< bool >::type silence(silenceSEXP);
+    rcpp_result_gen = Rcpp::wrap(extinctionProb(observations, ntype, transitions, silence));
+    return rcpp_result_gen;
+END_RCPP
+}
+// growthRate
+Rcpp::List growthRate(int ntype, Rcpp::List transitions, double period, double tol, int max_restarts, bool silence);
+RcppExport SEXP _estipop_growthRate(SEXP ntypeSEXP, SEXP transitionsSEXP, SEXP periodSEXP, SEXP tolSEXP, SEXP max_restartsSEXP, SEXP silenceSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type ntype(ntypeSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type transitions(transitionsSEXP);
+    Rcpp::traits::input_parameter< double >::type period(periodSEXP);
+    Rcpp::traits::input_parameter< double >::type tol(tolSEXP);
+    Rcpp::traits::input_parameter< int >::type max_restarts(max_restartsSEXP);
+    Rcpp::traits::input_parameter< bool >::type silence(silenceSEXP);
+    rcpp_result_gen = Rcpp::wrap(growthRate(ntype, transitions, period, tol, max_restarts, silence));
+    return rcpp_result_gen;
+END_RCPP
+}
+// bpLoglik
+double bpLoglik(Rcpp::NumericMatrix mom, Rcpp::NumericMatrix init_pop, Rcpp::NumericVector start_times, Rcpp::NumericVector end_times, Rcpp::NumericMatrix final_pop);
+RcppExport SEXP _estipop_bpLoglik(SEXP momSEXP, SEXP init_popSEXP, SEXP start_timesSEXP, SEXP end_timesSEXP, SEXP final_popSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type mom(momSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type init_pop(init_popSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type start_times(start_timesSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type end_times(end_timesSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type final_pop(final_popSEXP);
+    rcpp_result_gen = Rcpp::wrap(bpLoglik(mom, init_pop, start_times, end_times, final_pop));
+    return rcpp_result_gen;
+END_RCPP
+}
+// bpLoglikGrad
+Rcpp::NumericVector bpLoglikGrad(Rcpp::NumericMatrix mom, Rcpp::NumericMatrix init_pop, Rcpp::NumericVector start_times, Rcpp::NumericVector end_times, Rcpp::NumericMatrix final_pop);
+RcppExport SEXP _estipop_bpLoglikGrad(SEXP momSEXP, SEXP init_popSEXP, SEXP start_timesSEXP, SEXP end_timesSEXP, SEXP final_popSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type mom(momSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type init_pop(init_popSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type start_times(start_timesSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type end_times(end_timesSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type final_pop(final_popSEXP);
+    rcpp_result_gen = Rcpp::wrap(bpLoglikGrad(mom, init_pop, start_times, end_times, final_pop));
+    return rcpp_result_gen;
+END_RCPP
+}
+// composeMoments
+Rcpp::NumericMatrix composeMoments(Rcpp::NumericMatrix segments, Rcpp::NumericVector grid, Rcpp::NumericVector start_times, Rcpp::NumericVector end_times, int ntype, int nparam);
+RcppExport SEXP _estipop_composeMoments(SEXP segmentsSEXP, SEXP gridSEXP, SEXP start_timesSEXP, SEXP end_timesSEXP, SEXP ntypeSEXP, SEXP nparamSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::NumericMatrix >::type segments(segmentsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type grid(gridSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type start_times(start_timesSEXP);
+    Rcpp::traits::input_parameter< Rcpp::NumericVector >::type end_times(end_timesSEXP);
+    Rcpp::traits::input_parameter< int >::type ntype(ntypeSEXP);
+    Rcpp::traits::input_parameter< int >::type nparam(nparamSEXP);
+    rcpp_result_gen = Rcpp::wrap(composeMoments(segments, grid, start_times, end_times, ntype, nparam));
     return rcpp_result_gen;
 END_RCPP
 }
 
 static const R_CallMethodDef CallEntries[] = {
-    {"_estipop_gmbp3", (DL_FUNC) &_estipop_gmbp3, 8},
-    {"_estipop_timeDepBranch", (DL_FUNC) &_estipop_timeDepBranch, 8},
+    {"_estipop_gmbp3", (DL_FUNC) &_estipop_gmbp3, 11},
+    {"_estipop_timeDepBranch", (DL_FUNC) &_estipop_timeDepBranch, 12},
+    {"_estipop_ageDepBranch", (DL_FUNC) &_estipop_ageDepBranch, 9},
+    {"_estipop_sparseBranch", (DL_FUNC) &_estipop_sparseBranch, 9},
+    {"_estipop_splitBranch", (DL_FUNC) &_estipop_splitBranch, 10},
+    {"_estipop_mlmcBranch", (DL_FUNC) &_estipop_mlmcBranch, 12},
+    {"_estipop_langevinBranch", (DL_FUNC) &_estipop_langevinBranch, 10},
+    {"_estipop_lockstepBranch", (DL_FUNC) &_estipop_lockstepBranch, 9},
+    {"_estipop_abcSmc", (DL_FUNC) &_estipop_abcSmc, 15},
+    {"_estipop_particleFilter", (DL_FUNC) &_estipop_particleFilter, 11},
+    {"_estipop_sensitivityBranch", (DL_FUNC) &_estipop_sensitivityBranch, 11},
+    {"_estipop_superpositionLibrary", (DL_FUNC) &_estipop_superpositionLibrary, 7},
+    {"_estipop_superposeBranch", (DL_FUNC) &_estipop_superposeBranch, 7},
+    {"_estipop_birthDeathBranch", (DL_FUNC) &_estipop_birthDeathBranch, 9},
+    {"_estipop_extinctionProb", (DL_FUNC) &_estipop_extinctionProb, 4},
+    {"_estipop_growthRate", (DL_FUNC) &_estipop_growthRate, 6},
+    {"_estipop_bpLoglik", (DL_FUNC) &_estipop_bpLoglik, 5},
+    {"_estipop_bpLoglikGrad", (DL_FUNC) &_estipop_bpLoglikGrad, 5},
+    {"_estipop_composeMoments", (DL_FUNC) &_estipop_composeMoments, 6},
     {NULL, NULL, 0}
 };
 
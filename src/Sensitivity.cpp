@@ -0,0 +1,124 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Sensitivity.cpp
+ *
+ *    Description:  Parameter sensitivities of simulated populations
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 09:12:40
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "Sensitivity.h"
+#include "helpers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <gsl/gsl_randist.h>
+
+#include <Rcpp.h>
+
+Sensitivity::Sensitivity(System& sys, std::vector<std::vector<double> > p, std::vector<std::vector<double> > j)
+	: rates(sys.rates), from(sys.from), perturbed(p), jacobian(j), ntype(sys.state.size()), nparam(j.size()), events(0){
+	deltas = transitionDeltas(sys.updates, from);
+}
+
+Sensitivity::~Sensitivity(){}
+
+// Modified next reaction method: T[k] is the integrated propensity of transition k and P[k] the next point of its unit
+// Poisson process. Streams are reseeded per replicate, so every rate vector sees the same points.
+long int Sensitivity::path(const std::vector<long int>& init, const std::vector<double>& c, const std::vector<double>& obsTimes, gsl_rng** streams,
+                           unsigned long int seed, int rep, double* out, double* score) const{
+	int nrate = c.size();
+	int nobs = obsTimes.size();
+	std::vector<long int> x(init);
+	std::vector<double> a(nrate), T(nrate, 0), P(nrate);
+	std::vector<double> s(nparam, 0), b(nparam, 0);
+	for(int k = 0; k < nrate; k++){
+		seedStream(streams[k], seed, rep, k);
+		P[k] = gsl_ran_exponential(streams[k], 1);
+	}
+
+	double t = 0;
+	long int n = 0;
+	int o = 0;
+	while(o < nobs){
+		int mu = -1;
+		double dt = std::numeric_limits<double>::infinity();
+		for(int k = 0; k < nrate; k++){
+			a[k] = c[k] * x[from[k]];
+			if(a[k] > 0 && (P[k] - T[k]) / a[k] < dt){
+				dt = (P[k] - T[k]) / a[k];
+				mu = k;
+			}
+		}
+		// b[j] is the derivative of the total propensity, the rate at which the score drifts down between events
+		if(score){
+			for(int j = 0; j < nparam; j++){
+				b[j] = 0;
+				for(int k = 0; k < nrate; k++)
+					b[j] += jacobian[j][k] * x[from[k]];
+			}
+		}
+
+		// Record the observation times passed before the next event
+		while(o < nobs && obsTimes[o] < t + dt){
+			std::copy(x.begin(), x.end(), out + o * ntype);
+			if(score)
+				for(int j = 0; j < nparam; j++)
+					score[o * nparam + j] = s[j] - (obsTimes[o] - t) * b[j];
+			o++;
+		}
+		if(o == nobs)
+			break;
+
+		if(score)
+			for(int j = 0; j < nparam; j++)
+				s[j] += jacobian[j][mu] / c[mu] - dt * b[j];
+		for(int k = 0; k < nrate; k++)
+			T[k] += a[k] * dt;
+		for(int i = 0; i < ntype; i++)
+			x[i] += deltas[mu][i];
+		P[mu] += gsl_ran_exponential(streams[mu], 1);
+		t += dt;
+		n++;
+	}
+	return n;
+}
+
+void Sensitivity::simulate(const std::vector<long int>& init, const std::vector<double>& obsTimes, int reps, bool crn, bool lr, int threads, unsigned long int seed){
+	int nrate = rates.size();
+	int nobs = obsTimes.size();
+	size_t width = nobs * ntype;
+	nominal.assign(reps * width, 0);
+	shifted.assign(crn ? (size_t)nparam * reps * width : 0, 0);
+	scores.assign(lr ? (size_t)reps * nobs * nparam : 0, 0);
+	events = 0;
+
+	// One generator per transition per thread; replicate rep draws from the streams keyed on (seed, rep, transition)
+	// whatever thread runs it
+	ThreadRngs rngs(threads * nrate);
+	const int batch = 1000;
+	for(int start = 0; start < reps; start += batch){
+		int end = std::min(reps, start + batch);
+		long int n = 0;
+		#pragma omp parallel for num_threads(threads) schedule(dynamic) reduction(+:n)
+		for(int rep = start; rep < end; rep++){
+			gsl_rng** streams = &rngs.rngs[threadIndex() * nrate];
+			n += path(init, rates, obsTimes, streams, seed, rep, &nominal[rep * width], lr ? &scores[(size_t)rep * nobs * nparam] : nullptr);
+			if(crn)
+				for(int j = 0; j < nparam; j++)
+					n += path(init, perturbed[j], obsTimes, streams, seed, rep, &shifted[((size_t)j * reps + rep) * width], nullptr);
+		}
+		events += n;
+		Rcpp::checkUserInterrupt();
+	}
+}
@@ -0,0 +1,204 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Shard.cpp
+ *
+ *    Description:  Self-describing headers and mergeable summaries of simulator output
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 10:22:37
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "Shard.h"
+
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <stdexcept>
+#include <stdint.h>
+#include <algorithm>
+
+ShardHeader::ShardHeader() : format("csv"), ntype(0), seed(0), reps(0), shard(1), shards(1), first(1), last(0), model("") {}
+
+void ShardHeader::range(long int reps, int index, int count, long int& first, long int& last){
+	long int q = reps / count, r = reps % count;
+	first = q * (index - 1) + std::min<long int>(index - 1, r) + 1;
+	last = first + q - (index <= r ? 0 : 1);
+}
+
+std::string ShardHeader::line() const{
+	std::ostringstream s;
+	s << "# estipop-sim format=" << format << " types=" << ntype << " seed=" << seed << " reps=" << reps
+	  << " shard=" << shard << "/" << shards << " first=" << first << " last=" << last << " model=" << model;
+	return s.str();
+}
+
+ShardHeader ShardHeader::parse(const std::string& line){
+	std::istringstream in(line);
+	std::string word;
+	in >> word >> word;
+	if(word != "estipop-sim")
+		throw std::invalid_argument("Not an estipop-sim output file");
+
+	ShardHeader h;
+	while(in >> word){
+		size_t eq = word.find('=');
+		if(eq == std::string::npos)
+			continue;
+		std::string key = word.substr(0, eq), value = word.substr(eq + 1);
+		if(key == "format") h.format = value;
+		else if(key == "types") h.ntype = std::stoi(value);
+		else if(key == "seed") h.seed = std::stoul(value);
+		else if(key == "reps") h.reps = std::stol(value);
+		else if(key == "shard"){
+			size_t slash = value.find('/');
+			h.shard = std::stoi(value.substr(0, slash));
+			h.shards = std::stoi(value.substr(slash + 1));
+		}
+		else if(key == "first") h.first = std::stol(value);
+		else if(key == "last") h.last = std::stol(value);
+		else if(key == "model") h.model = value;
+	}
+	return h;
+}
+
+void ShardHeader::write(std::ostream& out) const{
+	std::string l = line();
+	if(format == "binary"){
+		uint32_t len = l.size();
+		out.write("ESTIPOP1", 8);
+		out.write((const char*)&len, sizeof(len));
+		out.write(l.data(), len);
+	} else {
+		out << l << "\n";
+	}
+}
+
+ShardHeader ShardHeader::read(std::istream& in){
+	char magic[8];
+	in.read(magic, 8);
+	if(in.gcount() == 8 && std::memcmp(magic, "ESTIPOP1", 8) == 0){
+		uint32_t len = 0;
+		in.read((char*)&len, sizeof(len));
+		std::string l(len, ' ');
+		in.read(&l[0], len);
+		return parse(l);
+	}
+	in.clear();
+	in.seekg(0);
+	std::string l;
+	getline(in, l);
+	return parse(l);
+}
+
+Summary::Summary(int k, std::vector<double> t) : ntype(k), times(t), n(t.size(), 0),
+	mean(t.size(), std::vector<double>(k, 0)), comoment(t.size(), std::vector<double>(k * k, 0)) {}
+
+void Summary::add(size_t obs, const long int* state){
+	double m = ++n[obs];
+	std::vector<double>& mu = mean[obs];
+	std::vector<double>& c = comoment[obs];
+	std::vector<double> before(ntype);
+	for(int i = 0; i < ntype; i++){
+		before[i] = state[i] - mu[i];
+		mu[i] += before[i] / m;
+	}
+	for(int j = 0; j < ntype; j++)
+		for(int i = 0; i < ntype; i++)
+			c[i + ntype * j] += before[i] * (state[j] - mu[j]);
+}
+
+void Summary::addRows(const std::string& rows){
+	size_t width = sizeof(int32_t) + sizeof(double) + sizeof(int64_t) * ntype;
+	std::vector<long int> state(ntype);
+	size_t obs = 0;
+	for(size_t off = 0; off + width <= rows.size() && obs < times.size(); off += width){
+		double time;
+		std::memcpy(&time, rows.data() + off + sizeof(int32_t), sizeof(double));
+		bool zero = true;
+		for(int i = 0; i < ntype; i++){
+			int64_t x;
+			std::memcpy(&x, rows.data() + off + sizeof(int32_t) + sizeof(double) + sizeof(int64_t) * i, sizeof(x));
+			state[i] = x;
+			zero = zero && x == 0;
+		}
+
+		if(time == times[obs]){
+			add(obs++, state.data());
+		} else if(zero){
+			// Extinct between observations: every later observation is zero
+			while(obs < times.size())
+				add(obs++, state.data());
+		}
+	}
+}
+
+void Summary::merge(const Summary& other){
+	if(other.ntype != ntype || other.times != times)
+		throw std::invalid_argument("Summaries have different types or observation times");
+	for(size_t t = 0; t < times.size(); t++){
+		double na = n[t], nb = other.n[t], total = na + nb;
+		if(nb == 0)
+			continue;
+		std::vector<double> delta(ntype);
+		for(int i = 0; i < ntype; i++){
+			delta[i] = other.mean[t][i] - mean[t][i];
+			mean[t][i] += delta[i] * nb / total;
+		}
+		for(int j = 0; j < ntype; j++)
+			for(int i = 0; i < ntype; i++)
+				comoment[t][i + ntype * j] += other.comoment[t][i + ntype * j] + delta[i] * delta[j] * na * nb / total;
+		n[t] = total;
+	}
+}
+
+void Summary::write(std::ostream& out) const{
+	out << std::setprecision(17);
+	for(size_t t = 0; t < times.size(); t++){
+		out << times[t] << "," << n[t];
+		for(int i = 0; i < ntype; i++)
+			out << "," << mean[t][i];
+		for(int i = 0; i < ntype; i++)
+			for(int j = i; j < ntype; j++)
+				out << "," << (n[t] > 1 ? comoment[t][i + ntype * j] / (n[t] - 1) : 0.0);
+		out << "\n";
+	}
+}
+
+void Summary::read(std::istream& in){
+	times.clear();
+	n.clear();
+	mean.clear();
+	comoment.clear();
+	std::string l;
+	while(getline(in, l)){
+		if(l.empty())
+			continue;
+		std::istringstream s(l);
+		std::vector<double> v;
+		std::string field;
+		while(getline(s, field, ','))
+			v.push_back(std::stod(field));
+		if(v.size() != (size_t)(2 + ntype + ntype * (ntype + 1) / 2))
+			throw std::invalid_argument("Malformed summary line");
+
+		times.push_back(v[0]);
+		n.push_back(v[1]);
+		mean.push_back(std::vector<double>(v.begin() + 2, v.begin() + 2 + ntype));
+		std::vector<double> c(ntype * ntype);
+		size_t k = 2 + ntype;
+		for(int i = 0; i < ntype; i++)
+			for(int j = i; j < ntype; j++, k++){
+				c[i + ntype * j] = v[k] * (v[1] > 1 ? v[1] - 1 : 0);
+				c[j + ntype * i] = c[i + ntype * j];
+			}
+		comoment.push_back(c);
+	}
+}
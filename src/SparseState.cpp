@@ -0,0 +1,146 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  SparseState.cpp
+ *
+ *    Description:  Open-addressing map of live type counts with proportional sampling
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 15:40:09
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "SparseState.h"
+
+#include <algorithm>
+
+SparseState::SparseState(){
+	clear();
+}
+
+SparseState::~SparseState(){}
+
+void SparseState::clear(){
+	Entry empty = {0, 0};
+	slots.assign(16, empty);
+	tree.assign(17, 0);
+	live = 0;
+	total = 0;
+}
+
+size_t SparseState::home(long long id){
+	unsigned long long z = (unsigned long long)id + 0x9e3779b97f4a7c15ULL;
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	z = z ^ (z >> 31);
+	return z & (slots.size() - 1);
+}
+
+// Slot holding id, or the empty slot where it would be inserted
+size_t SparseState::find(long long id){
+	size_t mask = slots.size() - 1;
+	size_t i = home(id);
+	while(slots[i].count != 0 && slots[i].id != id)
+		i = (i + 1) & mask;
+	return i;
+}
+
+void SparseState::treeAdd(size_t slot, long int delta){
+	for(size_t i = slot + 1; i < tree.size(); i += i & (~i + 1))
+		tree[i] += delta;
+}
+
+void SparseState::rebuild(size_t capacity){
+	std::vector<Entry> old;
+	old.swap(slots);
+	Entry empty = {0, 0};
+	slots.assign(capacity, empty);
+	tree.assign(capacity + 1, 0);
+	for(size_t i = 0; i < old.size(); i++){
+		if(old[i].count != 0){
+			size_t s = find(old[i].id);
+			slots[s] = old[i];
+			treeAdd(s, old[i].count);
+		}
+	}
+}
+
+void SparseState::erase(size_t slot){
+	size_t mask = slots.size() - 1;
+	size_t hole = slot;
+	slots[hole].count = 0;
+	live--;
+
+	// Shift back any entry that probed past the hole
+	for(size_t i = (hole + 1) & mask; slots[i].count != 0; i = (i + 1) & mask){
+		size_t h = home(slots[i].id);
+		if(((i - h) & mask) >= ((i - hole) & mask)){
+			treeAdd(i, -slots[i].count);
+			treeAdd(hole, slots[i].count);
+			slots[hole] = slots[i];
+			slots[i].count = 0;
+			hole = i;
+		}
+	}
+}
+
+long int SparseState::count(long long id){
+	return slots[find(id)].count;
+}
+
+void SparseState::add(long long id, long int delta){
+	if(delta == 0)
+		return;
+
+	size_t s = find(id);
+	if(slots[s].count == 0){
+		if(delta < 0)
+			return;
+		if(2 * (live + 1) > slots.size()){
+			rebuild(2 * slots.size());
+			s = find(id);
+		}
+		slots[s].id = id;
+		live++;
+	}
+
+	// Counts never go negative, matching System::updateSystem
+	delta = std::max(delta, -slots[s].count);
+	slots[s].count += delta;
+	total += delta;
+	treeAdd(s, delta);
+	if(slots[s].count == 0)
+		erase(s);
+}
+
+long long SparseState::sample(double u){
+	long int target = std::min((long int)(u * total), total - 1);
+	size_t pos = 0;
+	size_t step = 1;
+	while(2 * step < tree.size())
+		step *= 2;
+	for(; step > 0; step /= 2){
+		if(pos + step < tree.size() && tree[pos + step] <= target){
+			pos += step;
+			target -= tree[pos];
+		}
+	}
+	return slots[pos].id;
+}
+
+std::vector<SparseState::Entry> SparseState::entries(){
+	std::vector<Entry> out;
+	out.reserve(live);
+	for(size_t i = 0; i < slots.size(); i++){
+		if(slots[i].count != 0)
+			out.push_back(slots[i]);
+	}
+	std::sort(out.begin(), out.end(), [](const Entry& a, const Entry& b){ return a.id < b.id; });
+	return out;
+}
@@ -0,0 +1,127 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  SparseSystem.cpp
+ *
+ *    Description:  Branching process over a dynamic, sparse set of types
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 16:05:31
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "SparseSystem.h"
+
+#include <fstream>
+#include <algorithm>
+#include <gsl/gsl_randist.h>
+
+#include <Rcpp.h>
+
+extern gsl_rng* rng;
+extern bool silent;
+
+SparseSystem::SparseSystem() : rep_num(1), nextId(1), sumRate(0), recordLineage(false) {}
+
+SparseSystem::~SparseSystem(){}
+
+void SparseSystem::reset(const std::vector<long long>& ids, const std::vector<long int>& counts){
+	state.clear();
+	lineage.clear();
+	nextId = 1;
+	for(size_t i = 0; i < ids.size(); i++){
+		state.add(ids[i], counts[i]);
+		nextId = std::max(nextId, ids[i] + 1);
+		if(recordLineage && counts[i] > 0)
+			lineage.root(ids[i]);
+	}
+}
+
+void SparseSystem::nextRep(){
+	++rep_num;
+}
+
+// One row per live type: rep, time, type id, count
+void SparseSystem::toFile(double time, std::string file){
+	std::ofstream of;
+
+	of.open(file, std::fstream::in | std::fstream::out | std::fstream::app);
+	std::vector<SparseState::Entry> live = state.entries();
+	for(size_t i = 0; i < live.size(); i++){
+		of << rep_num << "," << time << "," << live[i].id << "," << live[i].count << "\n";
+	}
+}
+
+void SparseSystem::addRule(SparseRule r){
+	rules.push_back(r);
+	sumRate += r.rate;
+	cumRates.push_back(sumRate);
+}
+
+long long SparseSystem::mutate(long long parent, int mutation){
+	if(mutation == 1)
+		return nextId++;
+	if(mutation == 2)
+		return gsl_rng_uniform(rng) < 0.5 ? parent - 1 : parent + 1;
+	return parent;
+}
+
+void SparseSystem::simulate(std::vector<double> obsTimes, std::string file){
+	double totTime = obsTimes[obsTimes.size()-1];
+	double curTime = 0;
+	size_t curObsIndex = 0;
+
+	if(!silent){
+		std::cout << "Simulation Start Time: " << curTime << std::endl;
+		std::cout << "Simulation End Time: " << totTime << std::endl;
+		std::cout << "obsTimes.size(): " << obsTimes.size() << std::endl;
+	}
+
+	long int nevents = 0;
+	while(curObsIndex < obsTimes.size()){
+		if((++nevents & 0xFFFF) == 0)
+			Rcpp::checkUserInterrupt();
+
+		if(state.total == 0){
+			if(!silent)
+				std::cout << "All populations have gone extinct.  Exiting simulation..." << std::endl;
+			break;
+		}
+
+		// Every individual carries every rule, so the total rate only depends on the population size
+		curTime += gsl_ran_exponential(rng, 1 / (sumRate * state.total));
+
+		while(curObsIndex < obsTimes.size() && curTime > obsTimes[curObsIndex]){
+			toFile(obsTimes[curObsIndex], file);
+			curObsIndex++;
+		}
+		if(curObsIndex >= obsTimes.size())
+			break;
+
+		double r = gsl_rng_uniform(rng) * sumRate;
+		size_t k = std::upper_bound(cumRates.begin(), cumRates.end(), r) - cumRates.begin();
+		k = std::min(k, rules.size() - 1);
+		const SparseRule& rule = rules[k];
+
+		long long parent = state.sample(gsl_rng_uniform(rng));
+		if(rule.mutant > 0){
+			long long child = mutate(parent, rule.mutation);
+			bool founded = recordLineage && child != parent && state.count(child) == 0;
+			state.add(child, rule.mutant);
+			if(founded)
+				lineage.birth(child, parent, curTime, k);
+		}
+		state.add(parent, rule.same - 1);
+		if(recordLineage && state.count(parent) == 0)
+			lineage.extinct(parent);
+	}
+
+	if(!silent)
+		std::cout << "End Simulation Time: " << totTime << std::endl;
+}
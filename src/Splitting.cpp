@@ -0,0 +1,105 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Splitting.cpp
+ *
+ *    Description:  Fixed-effort multilevel splitting for rare target events
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 17:31:46
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "Splitting.h"
+
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <gsl/gsl_randist.h>
+
+#include <Rcpp.h>
+
+extern gsl_rng* rng;
+extern bool silent;
+
+// A state saved at a level crossing
+struct Entrance {
+	std::vector<long int> state;
+	double time;
+};
+
+SplitResult multilevelSplitting(System& sys, const std::vector<long int>& init, const StopCriterion& target,
+                                std::vector<double> levels, double horizon, int effort, double budget, int maxReps){
+	if(target.inequality != ">" && target.inequality != ">=")
+		throw std::invalid_argument("The target must be of the form sum > value or sum >= value");
+
+	// Target set as an integer threshold on the importance sum, appended as the last level
+	double final = target.inequality == ">" ? std::floor(target.value) + 1 : std::ceil(target.value);
+	for(size_t k = 0; k < levels.size(); k++){
+		if(levels[k] >= final || (k > 0 && levels[k] <= levels[k-1]))
+			throw std::invalid_argument("Levels must increase and lie below the target");
+	}
+	levels.push_back(final);
+	int nlevels = levels.size();
+
+	std::vector<double> o_rates(sys.rates.size(), 0.0);
+	std::vector<double> estimates;
+	std::vector<double> levelSums(nlevels, 0.0);
+	std::vector<Entrance> current, next;
+	auto start = std::chrono::steady_clock::now();
+
+	while((int)estimates.size() < maxReps){
+		double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if(estimates.size() >= 2 && elapsed > budget)
+			break;
+
+		current.assign(1, Entrance{init, 0.0});
+		double estimate = 1;
+		for(int k = 0; k < nlevels; k++){
+			next.clear();
+			for(int n = 0; n < effort; n++){
+				Rcpp::checkUserInterrupt();
+
+				const Entrance& e = current[gsl_rng_uniform_int(rng, current.size())];
+				sys.reset(e.state);
+				double time = e.time;
+				if(sys.advance(time, horizon, target, levels[k], o_rates))
+					next.push_back(Entrance{sys.state, time});
+			}
+
+			double p = next.size() / (double)effort;
+			levelSums[k] += p;
+			estimate *= p;
+			if(next.empty())
+				break;
+			current.swap(next);
+		}
+		estimates.push_back(estimate);
+
+		if(!silent)
+			std::cout << "Replication " << estimates.size() << ": " << estimate << std::endl;
+	}
+
+	SplitResult res;
+	res.replications = estimates.size();
+	res.estimate = 0;
+	for(size_t r = 0; r < estimates.size(); r++)
+		res.estimate += estimates[r];
+	res.estimate /= res.replications;
+
+	double ss = 0;
+	for(size_t r = 0; r < estimates.size(); r++)
+		ss += (estimates[r] - res.estimate) * (estimates[r] - res.estimate);
+	res.variance = res.replications > 1 ? ss / (res.replications - 1) / res.replications : NAN;
+
+	res.levelProbs.resize(nlevels);
+	for(int k = 0; k < nlevels; k++)
+		res.levelProbs[k] = levelSums[k] / res.replications;
+	return res;
+}
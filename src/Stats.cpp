@@ -0,0 +1,56 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Stats.cpp
+ *
+ *    Description:  Per-replicate simulation counters and phase timers
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 10:31:07
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "Stats.h"
+
+void SimulationStats::merge(const SimulationStats& other){
+	replicates += other.replicates;
+	stopped += other.stopped;
+	extinct += other.extinct;
+	if(events.size() < other.events.size())
+		events.resize(other.events.size(), 0);
+	for(size_t i = 0; i < other.events.size(); i++)
+		events[i] += other.events[i];
+	proposals += other.proposals;
+	accepts += other.accepts;
+	stopChecks += other.stopChecks;
+	majorantBuilds += other.majorantBuilds;
+	rows += other.rows;
+	outputBytes += other.outputBytes;
+	majorantSeconds += other.majorantSeconds;
+	outputSeconds += other.outputSeconds;
+	simulateSeconds += other.simulateSeconds;
+}
+
+void SimulationStats::print(std::ostream& out) const{
+	long int total = 0;
+	for(size_t i = 0; i < events.size(); i++)
+		total += events[i];
+	out << "replicates " << replicates << " (" << stopped << " stopped, " << extinct << " extinct)\n"
+	    << "events " << total << ":";
+	for(size_t i = 0; i < events.size(); i++)
+		out << " " << events[i];
+	out << "\n";
+	if(proposals > 0)
+		out << "thinning " << accepts << " of " << proposals << " proposals accepted\n";
+	if(majorantBuilds > 0)
+		out << "majorant " << majorantBuilds << " builds in " << majorantSeconds << " s\n";
+	out << "stop checks " << stopChecks << "\n"
+	    << "output " << rows << " rows, " << outputBytes << " bytes in " << outputSeconds << " s\n"
+	    << "simulate " << simulateSeconds << " s" << std::endl;
+}
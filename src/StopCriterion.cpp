@@ -33,11 +33,16 @@ StopCriterion::StopCriterion(std::vector<int> ind, std::string ineq, double v) :
 
 StopCriterion::~StopCriterion(){}
 
-bool StopCriterion::check(std::vector<long int> state){
+long int StopCriterion::level(const std::vector<long int>& state) const{
 	long int checkVal = 0;
 	for(size_t i = 0; i < indices.size(); i++){
 		checkVal += state[indices[i]];
 	}
+	return checkVal;
+}
+
+bool StopCriterion::check(std::vector<long int> state){
+	long int checkVal = level(state);
 
 	if(inequality == ">"){
 		if(checkVal > value)
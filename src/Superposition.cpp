@@ -0,0 +1,174 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  Superposition.cpp
+ *
+ *    Description:  Large initial populations as sums of single-ancestor outcomes
+ *
+ *        Version:  1.0
+ *        Created:  10/18/2026 10:41:07
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  Jeremy Ferlic (), jferlic@g.harvard.edu
+ *   Organization:  Harvard University
+ *
+ * =====================================================================================
+ */
+
+#include "Superposition.h"
+#include "helpers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <gsl/gsl_randist.h>
+
+#include <Rcpp.h>
+
+extern bool silent;
+
+Superposition::Superposition(int t, int o) : ntype(t), nobs(o), width(t * o), library(t), mean(t), factor(t){}
+
+Superposition::~Superposition(){}
+
+long int Superposition::size(int type) const{
+	return library[type].size() / width;
+}
+
+// Cholesky factor of a covariance that may be singular: a type never reached, a total conserved by every transition
+// or an observation at time 0 all leave zero pivots, whose columns are dropped
+static void semidefiniteFactor(std::vector<double>& a, int n){
+	double scale = 0;
+	for(int j = 0; j < n; ++j)
+		scale = std::max(scale, a[j + n*j]);
+	double eps = 1e-12 * scale;
+	for(int j = 0; j < n; ++j){
+		double d = a[j + n*j];
+		for(int k = 0; k < j; ++k)
+			d -= a[j + n*k] * a[j + n*k];
+		bool zero = !(d > eps);
+		d = zero ? 0 : sqrt(d);
+		a[j + n*j] = d;
+		for(int i = j + 1; i < n; ++i){
+			double s = a[i + n*j];
+			for(int k = 0; k < j; ++k)
+				s -= a[i + n*k] * a[j + n*k];
+			a[i + n*j] = zero ? 0 : s / d;
+		}
+	}
+}
+
+void Superposition::build(System& sys, const std::vector<double>& obsTimes, int size, int threads, unsigned long int seed){
+	const std::vector<double>& rates = sys.rates;
+	const std::vector<int>& from = sys.from;
+	int nrate = rates.size();
+	std::vector<std::vector<int> > deltas = transitionDeltas(sys.updates, from);
+
+	// Outcome l of type i is drawn from the stream keyed on (seed, i, l), whatever thread runs it
+	ThreadRngs rngs(threads);
+	const int batch = 1000;
+	for(int i = 0; i < ntype; i++){
+		if(!silent) std::cout << "Simulating " << size << " single ancestors of type " << i + 1 << "..." << std::endl;
+		library[i].assign((size_t)size * width, 0);
+		for(int start = 0; start < size; start += batch){
+			int end = std::min(size, start + batch);
+			#pragma omp parallel for num_threads(threads) schedule(dynamic)
+			for(int l = start; l < end; l++){
+				gsl_rng* r = rngs.rngs[threadIndex()];
+				seedStream(r, seed, i, l);
+				double* out = &library[i][(size_t)l * width];
+				std::vector<long int> x(ntype, 0);
+				std::vector<double> a(nrate);
+				x[i] = 1;
+
+				// Gillespie's direct method, recording the state at the observation times passed before each event
+				double t = 0;
+				int o = 0;
+				while(o < nobs){
+					double total = 0;
+					for(int k = 0; k < nrate; k++){
+						a[k] = rates[k] * x[from[k]];
+						total += a[k];
+					}
+					double dt = total > 0 ? gsl_ran_exponential(r, 1 / total) : std::numeric_limits<double>::infinity();
+					while(o < nobs && obsTimes[o] < t + dt){
+						std::copy(x.begin(), x.end(), out + o * ntype);
+						o++;
+					}
+					if(o == nobs)
+						break;
+					int mu = chooseTransition(a, total, r);
+					for(int j = 0; j < ntype; j++)
+						x[j] += deltas[mu][j];
+					t += dt;
+				}
+			}
+			Rcpp::checkUserInterrupt();
+		}
+	}
+}
+
+void Superposition::moments(const std::vector<bool>& types){
+	for(int i = 0; i < ntype; i++){
+		if(!types[i])
+			continue;
+		long int n = size(i);
+		const std::vector<double>& lib = library[i];
+		mean[i].assign(width, 0);
+		factor[i].assign(width * width, 0);
+		for(long int l = 0; l < n; l++)
+			for(int c = 0; c < width; c++)
+				mean[i][c] += lib[l * width + c] / n;
+		for(long int l = 0; l < n; l++)
+			for(int c = 0; c < width; c++)
+				for(int d = c; d < width; d++)
+					factor[i][d + width * c] += (lib[l * width + c] - mean[i][c]) * (lib[l * width + d] - mean[i][d]) / std::max(n - 1, 1L);
+		semidefiniteFactor(factor[i], width);
+	}
+}
+
+void Superposition::sample(const std::vector<long int>& init, double cltThreshold, gsl_rng* r, double* out) const{
+	std::fill(out, out + width, 0.0);
+	std::vector<double> z(width);
+	for(int i = 0; i < ntype; i++){
+		long int N = init[i];
+		long int n = size(i);
+		const std::vector<double>& lib = library[i];
+		if(N == 0)
+			continue;
+
+		if(N > cltThreshold){
+			for(int c = 0; c < width; c++)
+				z[c] = gsl_ran_ugaussian(r);
+			double s = sqrt((double)N);
+			for(int c = 0; c < width; c++){
+				double v = N * mean[i][c];
+				for(int k = 0; k <= c; k++)
+					v += s * factor[i][c + width * k] * z[k];
+				out[c] += v;
+			}
+		} else if(N <= n){
+			for(long int a = 0; a < N; a++){
+				const double* row = &lib[gsl_rng_uniform_int(r, n) * width];
+				for(int c = 0; c < width; c++)
+					out[c] += row[c];
+			}
+		} else {
+			// More ancestors than outcomes: how often each outcome is drawn is multinomial, so the cost is that of
+			// the library rather than of the population
+			std::vector<double> p(n, 1.0);
+			std::vector<unsigned int> counts(n);
+			gsl_ran_multinomial(r, n, N, p.data(), counts.data());
+			for(long int l = 0; l < n; l++){
+				if(counts[l] == 0)
+					continue;
+				const double* row = &lib[l * width];
+				for(int c = 0; c < width; c++)
+					out[c] += counts[l] * row[c];
+			}
+		}
+	}
+	for(int c = 0; c < width; c++)
+		out[c] = std::max(0.0, floor(out[c] + 0.5));
+}
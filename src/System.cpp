@@ -19,37 +19,38 @@
 
 #include "System.h"
 #include "helpers.h"
+#include "CalendarQueue.h"
+#include "ConstantRate.h"
 
 #include <iostream>
 #include <fstream>
 #include <gsl/gsl_randist.h>
 #include <sstream>
 #include <iomanip>
+#include <limits>
+#include <numeric>
+#include <stdint.h>
 
+#ifndef ESTIPOP_STANDALONE
 #include <RcppGSL.h>
 #include <Rcpp.h>
 #include <Rinternals.h>
+#endif
 
 extern gsl_rng* rng;
 extern bool silent;
 
-void out(std::string s){
-	//std::cout << s << std::endl;
+#ifdef ESTIPOP_STATS
+static double seconds(){
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
 }
+#endif
 
-template <typename T>
-std::string to_string_wp(const T a_value, const int n = 20)
-{
-    std::ostringstream out;
-    out << std::setprecision(n) << a_value;
-    return out.str();
-}
-
-System::System(){
+System::System() : gen(rng){
 
 }
 
-System::System(std::vector<long int> s){
+System::System(std::vector<long int> s) : gen(rng){
 	reset(s);
 	rep_num = 1;
 }
@@ -77,15 +78,94 @@ void System::print(){
 }
 
 void System::toFile(double time, std::string file){
+	STATS(double statsStart = seconds(); stats.rows++;)
+	if(sink){
+		STATS(std::streamoff before = sink->tellp();)
+		if(binary){
+			int32_t rep = rep_num;
+			sink->write((const char*)&rep, sizeof(rep));
+			sink->write((const char*)&time, sizeof(time));
+			for(size_t i = 0; i < state.size(); i++){
+				int64_t x = state[i];
+				sink->write((const char*)&x, sizeof(x));
+			}
+		} else {
+			*sink << rep_num << "," << time << "," << state[0];
+			for(size_t i = 1; i < state.size(); i++)
+				*sink << "," << state[i];
+			*sink << "\n";
+		}
+		STATS(stats.outputBytes += sink->tellp() - before; stats.outputSeconds += seconds() - statsStart;)
+		return;
+	}
+
 	std::ofstream of;
 
     of.open(file, std::fstream::in | std::fstream::out | std::fstream::app);
+	STATS(of.seekp(0, std::ios::end); std::streamoff before = of.tellp();)
 	of << rep_num << "," << time << "," << state[0];
 	for(size_t i = 1; i < state.size(); i++){
 		of << "," << state[i];
 	}
 
 	of << std::endl;
+	STATS(stats.outputBytes += of.tellp() - before; stats.outputSeconds += seconds() - statsStart;)
+}
+
+void System::enableCheckpoints(std::string file, double every){
+	checkpointFile = file;
+	checkpointEvery = every;
+	lastCheckpoint = std::chrono::steady_clock::now();
+}
+
+Checkpoint System::snapshot(double curTime, int curObsIndex, std::string file){
+	Checkpoint c;
+	c.rep = rep_num;
+	c.time = curTime;
+	c.obs = curObsIndex;
+	c.state = state;
+	c.saveRng(gen);
+	if(sink){
+		sink->flush();
+		c.offset = sink->tellp();
+	} else {
+		c.offset = fileSize(file);
+	}
+	return c;
+}
+
+void System::resumeFrom(const Checkpoint& c){
+	if(c.state.size() != state.size())
+		throw std::invalid_argument("Checkpoint has a different number of types");
+	c.restoreRng(gen);
+	state = c.state;
+	rep_num = c.rep;
+	resumePoint = c;
+	resuming = true;
+}
+
+void System::poll(double curTime, int curObsIndex, std::string file){
+	if(checkpointFile.empty()){
+		checkInterrupt();
+		return;
+	}
+	try{
+		checkInterrupt();
+	}
+	catch(...){
+		snapshot(curTime, curObsIndex, file).write(checkpointFile);
+		throw;
+	}
+
+	// Reading the clock on every event would cost more than the snapshots
+	if(++sinceClock < 1024)
+		return;
+	sinceClock = 0;
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if(std::chrono::duration<double>(now - lastCheckpoint).count() >= checkpointEvery){
+		snapshot(curTime, curObsIndex, file).write(checkpointFile);
+		lastCheckpoint = now;
+	}
 }
 
 void System::updateSystem(std::vector<int> update){
@@ -118,11 +198,15 @@ void System::addStop(StopCriterion c){
 	stops.push_back(c);
 }
 
+void System::addLifetime(Lifetime l){
+	lifetimes.push_back(l);
+}
+
 double System::getNextTime(std::vector<double>& o_rates){
 	for(size_t i = 0; i < rates.size(); i++){
 		o_rates[i] = rates[i] * state[from[i]];
 	}
-  double next_time = gsl_ran_exponential(rng, 1 / std::accumulate(o_rates.begin(), o_rates.end(), 0.0));
+  double next_time = gsl_ran_exponential(gen, 1 / std::accumulate(o_rates.begin(), o_rates.end(), 0.0));
 	return(next_time);
 }
 
@@ -140,6 +224,12 @@ void System::simulate(std::vector<double> obsTimes, std::string file){
     // Set variables to keep track of our current time and which observation time comes next
     double curTime = 0;
     int curObsIndex = 0;
+	STATS(double statsStart = seconds(); stats.replicates++; stats.events.resize(std::max(stats.events.size(), updates.size()), 0);)
+	if(resuming){
+		curTime = resumePoint.time;
+		curObsIndex = resumePoint.obs;
+		resuming = false;
+	}
 
     int obsMod = std::max(1, (int)pow(10, round(log10(totTime)-1)));
 
@@ -153,7 +243,7 @@ void System::simulate(std::vector<double> obsTimes, std::string file){
     // Run until our currentTime is greater than our largest Observation time
     while(curTime <= obsTimes[obsTimes.size()-1])
     {
-        Rcpp::checkUserInterrupt();
+        poll(curTime, curObsIndex, file);
 
         // Get the next event time
         double timeToNext = getNextTime(o_rates);
@@ -170,15 +260,16 @@ void System::simulate(std::vector<double> obsTimes, std::string file){
 
 			curObsIndex++;
 
-			if((unsigned)curObsIndex >= obsTimes.size()-1)
+			if((unsigned)curObsIndex >= obsTimes.size())
 				break;
         }
 
-		//if((unsigned)curObsIndex >= obsTimes.size()-1)
+		//if((unsigned)curObsIndex >= obsTimes.size())
 			//	break;
 
         // Update our System
-        int index = choose(o_rates);
+        int index = choose(o_rates, gen);
+		STATS(stats.events[index]++;)
 
 
 		std::vector<int> update = updates[index].get();
@@ -190,12 +281,14 @@ void System::simulate(std::vector<double> obsTimes, std::string file){
 
 		bool stop = false;
 
+		STATS(stats.stopChecks += stops.size();)
 		for(size_t i = 0; i < stops.size(); i++){
 			if(stops[i].check(state))
 				stop = true;
 		}
 
 		if(stop){
+			STATS(stats.stopped++;)
 			toFile(curTime, file);
 			if(!silent)
 				std::cout << "A stopping criterion has been met. Exiting simulation..." << std::endl;
@@ -209,6 +302,7 @@ void System::simulate(std::vector<double> obsTimes, std::string file){
 		}
 
 		if(zero){
+			STATS(stats.extinct++;)
 			toFile(curTime, file);
 			if(!silent)
 				std::cout << "All populations have gone extinct.  Exiting simulation..." << std::endl;
@@ -216,84 +310,79 @@ void System::simulate(std::vector<double> obsTimes, std::string file){
 		}
 
     }
+	STATS(stats.simulateSeconds += seconds() - statsStart;)
 		if(!silent)
 	std::cout << "End Simulation Time: " << obsTimes[obsTimes.size()-1] << std::endl;
 	if(!silent)
 		std::cout << "Actual current time: " << curTime << std::endl;
 }
 
-double System::getNextTime2(double curTime, double totTime){
-	std::cout.precision(20);
-	double tot_rate;
-	double rand_next_time = 0.0;
-	double tot_rate_homog;
-	int currbin;
-  //Rcpp::Rcout << "tot_rate_homog " << tot_rate_homog << "\n";
-
-
-
-	while(true){
-		Rcpp::checkUserInterrupt();
-
-		tot_rate = 0;
-		tot_rate_homog = 0;
-		currbin = floor((curTime + rand_next_time)/totTime*nbins);
-
-		for(int i = 0; i < rates2.size(); ++i){
-			tot_rate_homog += homog_rates[i][currbin]*state[from[i]];
-		}
-
-		out("tot_rate_homog: " + to_string_wp(tot_rate_homog));
-		rand_next_time += gsl_ran_exponential(rng, 1 / tot_rate_homog);
-
+// Constant rates are pulled out once so they can be sampled exactly; the majorant tables only cover the rest
+void System::splitClocks(double totTime){
+	if(majorantEnd == totTime)
+		return;
 
-		out("starting loop");
-		for(size_t i = 0; i < rates2.size(); i++){
-			tot_rate += (*rates2[i])(curTime + rand_next_time) * state[from[i]];
-		}
-		out("ending loop");
-
-		double u_thin = gsl_ran_flat(rng, 0, 1);
-		double beta_ratio = tot_rate / tot_rate_homog;
-    	//Rcpp::Rcout << "homog rate: " << tot_rate_homog << "\n";
-    	//Rcpp::Rcout << "total rate: " << tot_rate << "\n";
-		//Rcpp::Rcout << "beta ratio: " << beta_ratio << "\n";
-
-		if(u_thin <= beta_ratio || curTime + rand_next_time >= totTime)
-		{
-		  break;
+	exactIndex.clear();
+	exactRates.clear();
+	thinIndex.clear();
+	for(size_t i = 0; i < rates2.size(); i++){
+		ConstantRate* c = dynamic_cast<ConstantRate*>(rates2[i]);
+		if(c){
+			exactIndex.push_back(i);
+			exactRates.push_back(c->params.rate);
+		} else {
+			thinIndex.push_back(i);
 		}
 	}
-	out("Returning from nextTime2 with: " + to_string_wp(rand_next_time));
-	if(rand_next_time <= 0){
-		out("I'VE RETURNED A ZERO TIME TO NEXT EVENT!!!");
-	}
 
-	return(rand_next_time);
+	STATS(double statsStart = seconds();)
+	homog_rates = std::vector<std::vector<double>>(thinIndex.size(), std::vector<double>(nbins, 0.0));
+	for(size_t k = 0; k < thinIndex.size(); k++){
+		rates2[thinIndex[k]]->fillMajorant(0, totTime, nbins, homog_rates[k], .01);
+	}
+	majorantEnd = totTime;
+	STATS(stats.majorantBuilds++; stats.majorantSeconds += seconds() - statsStart;)
 }
 
-int System::getNextEvent2(double curTime, double timeToNext){
-	std::vector<double> cumulativeHazards;
+// Next event of the time-dependent transitions, thinned against homog_rates. Each bin holds the maximum over the
+// rest of the horizon, so the bound in force at a proposal stays valid until the next one. Returns infinity when
+// nothing is accepted before endTime; otherwise o_rates holds the thinned hazards at the accepted time.
+double System::getNextTime2(double curTime, double endTime, double totTime, std::vector<double>& o_rates){
+	double t = curTime;
 
-	out("in nextEvent2");
+	while(true){
+		checkInterrupt();
 
+		int currbin = std::min(nbins - 1, (int)floor(t/totTime*nbins));
+		double tot_rate_homog = 0;
+		for(size_t k = 0; k < thinIndex.size(); ++k){
+			tot_rate_homog += homog_rates[k][currbin]*state[from[thinIndex[k]]];
+		}
+		if(tot_rate_homog <= 0)
+			return std::numeric_limits<double>::infinity();
+
+		t += gsl_ran_exponential(gen, 1 / tot_rate_homog);
+		if(t >= endTime)
+			return std::numeric_limits<double>::infinity();
+		STATS(stats.proposals++;)
+
+		double tot_rate = 0;
+		for(size_t k = 0; k < thinIndex.size(); k++){
+			o_rates[k] = (*rates2[thinIndex[k]])(t) * state[from[thinIndex[k]]];
+			tot_rate += o_rates[k];
+		}
 
-	for(size_t i = 0; i < rates2.size(); i++){
-		cumulativeHazards.push_back((*rates2[i])(curTime + timeToNext) * state[from[i]]);
+		if(gsl_ran_flat(gen, 0, 1) * tot_rate_homog <= tot_rate){
+			STATS(stats.accepts++;)
+			return t - curTime;
+		}
 	}
-
-	out("returning from nextEvetn2");
-	return choose(cumulativeHazards);
 }
 
 void System::simulate_timedep(std::vector<double> obsTimes, std::string file){
 	bool verbose = false;
-	std::cout.precision(60);
 
-	std::vector<double> o_rates;
-	for(size_t i = 0; i < rates.size(); i++){
-		o_rates.push_back(0.0);
-	}
+	const double never = std::numeric_limits<double>::infinity();
 
 	double totTime = obsTimes[obsTimes.size()-1];
 
@@ -301,6 +390,12 @@ void System::simulate_timedep(std::vector<double> obsTimes, std::string file){
     // Set variables to keep track of our current time and which observation time comes next
     double curTime = 0;
     int curObsIndex = 0;
+	STATS(double statsStart = seconds(); stats.replicates++; stats.events.resize(std::max(stats.events.size(), updates.size()), 0);)
+	if(resuming){
+		curTime = resumePoint.time;
+		curObsIndex = resumePoint.obs;
+		resuming = false;
+	}
 
 	int obsMod = std::max(1, (int)pow(10, round(log10(totTime)-1)));
 
@@ -311,29 +406,31 @@ void System::simulate_timedep(std::vector<double> obsTimes, std::string file){
 		std::cout << "obsTimes.size(): " << obsTimes.size() << std::endl;
 	}
 
-
-	homog_rates = std::vector<std::vector<double>>(rates2.size(), std::vector<double>(nbins, 0.0));
- 	std::vector<double> tmp = std::vector<double>(nbins, 0.0);
-	for(size_t i = 0; i < rates2.size(); i++){
-    	maximizePiecewise(rates2[i]->funct, 0, totTime, nbins, homog_rates[i], .01);
-	}
+	splitClocks(totTime);
+	std::vector<double> exact_rates(exactIndex.size(), 0.0);
+	std::vector<double> thin_rates(thinIndex.size(), 0.0);
 
     // Run until our currentTime is greater than our largest Observation time
     while(curTime <= obsTimes[obsTimes.size()-1])
     {
-        Rcpp::checkUserInterrupt();
+        poll(curTime, curObsIndex, file);
 
-        // Get the next event time
-        double timeToNext = getNextTime2(curTime, totTime);
+		// The two groups are independent clocks: draw the exact one, then thin the other only up to that time
+		double exact_total = 0;
+		for(size_t k = 0; k < exactIndex.size(); k++){
+			exact_rates[k] = exactRates[k] * state[from[exactIndex[k]]];
+			exact_total += exact_rates[k];
+		}
+		double exactNext = exact_total > 0 ? gsl_ran_exponential(gen, 1 / exact_total) : never;
+		double thinNext = thinIndex.empty() ? never : getNextTime2(curTime, std::min(curTime + exactNext, totTime), totTime, thin_rates);
 
-		out("Got my next time: " + to_string_wp(timeToNext));
+		bool thinned = thinNext < never;
+        double timeToNext = thinned ? thinNext : exactNext;
 
         // If our next event time is later than observation times,
         // Make our observations
         while((curTime + timeToNext > obsTimes[curObsIndex]))// & (curTime + timeToNext <= obsTimes[numTime]))
         {
-			out("Time to next: " + to_string_wp(curTime + timeToNext) + " curObsIndex: " + to_string_wp(curObsIndex));
-			out("In the observation loop");
 			// print out current state vector
 			toFile(obsTimes[curObsIndex], file);
 
@@ -343,14 +440,18 @@ void System::simulate_timedep(std::vector<double> obsTimes, std::string file){
 			}
 			curObsIndex++;
 
-			if((unsigned)curObsIndex >= obsTimes.size()-1){
+			if((unsigned)curObsIndex >= obsTimes.size()){
 				break;
 			}
     }
 
+		// Nothing fires before the horizon
+		if(curTime + timeToNext > totTime)
+			break;
+
         // Update our System
-		out("headed from sim2 to getEvent2");
-        int index = getNextEvent2(curTime, timeToNext);
+        int index = thinned ? thinIndex[choose(thin_rates, gen)] : exactIndex[choose(exact_rates, gen)];
+		STATS(stats.events[index]++;)
 
 		std::vector<int> update = updates[index].get();
 		update[from[index]] = update[from[index]] - 1;
@@ -358,18 +459,20 @@ void System::simulate_timedep(std::vector<double> obsTimes, std::string file){
 
         // Increase our current time and get the next Event Time
         curTime = curTime + timeToNext;
-		out("Curtime: " + to_string_wp(curTime));
 
 		bool stop = false;
 
+		STATS(stats.stopChecks += stops.size();)
 		for(size_t i = 0; i < stops.size(); i++){
 			if(stops[i].check(state))
 				stop = true;
 		}
 
 		if(stop){
+			STATS(stats.stopped++;)
 			toFile(curTime, file);
-			std::cout << "A stopping criterion has been met. Exiting simulation..." << std::endl;
+			if(!silent)
+				std::cout << "A stopping criterion has been met. Exiting simulation..." << std::endl;
 			break;
 		}
 
@@ -380,14 +483,155 @@ void System::simulate_timedep(std::vector<double> obsTimes, std::string file){
 		}
 
 		if(zero){
+			STATS(stats.extinct++;)
 			toFile(curTime, file);
-			std::cout << "All populations have gone extinct.  Exiting simulation..." << std::endl;
+			if(!silent)
+				std::cout << "All populations have gone extinct.  Exiting simulation..." << std::endl;
 			break;
 		}
 
     }
+	STATS(stats.simulateSeconds += seconds() - statsStart;)
 	if(!silent)
 	std::cout << "End Simulation Time: " << obsTimes[obsTimes.size()-1] << std::endl;
 	if(!silent)
 		std::cout << "Actual current time: " << curTime << std::endl;
 }
+
+// Bellman-Harris simulation: each individual lives for a draw from its type's lifetime distribution, then is
+// replaced by the offspring of one of its type's transitions, chosen with probability proportional to the rate
+void System::simulate_age(std::vector<double> obsTimes, std::string file){
+	int ntype = state.size();
+	double totTime = obsTimes[obsTimes.size()-1];
+
+	if(lifetimes.size() != (size_t)ntype)
+		throw std::invalid_argument("Need one lifetime distribution per type");
+
+	// Transitions available at the end of each type's lifetime
+	std::vector<std::vector<int> > byType(ntype);
+	std::vector<std::vector<double> > cumProbs(ntype);
+	for(size_t r = 0; r < rates.size(); r++){
+		byType[from[r]].push_back(r);
+		cumProbs[from[r]].push_back(rates[r]);
+	}
+	double minMean = totTime;
+	for(int i = 0; i < ntype; i++){
+		if(!byType[i].empty()){
+			cumProbs[i] = normalize(cumProbs[i]);
+			minMean = std::min(minMean, lifetimes[i].mean());
+		}
+	}
+
+	// About 16 buckets per shortest mean lifetime keeps each bucket's heap small; the queue caps the count
+	size_t nbuckets = (size_t)std::min((double)CalendarQueue::maxBuckets, std::ceil(16 * totTime / std::max(minMean, 1e-12)));
+	CalendarQueue queue(0, totTime, nbuckets);
+
+	// Initial individuals are newborn at time 0; types without transitions are never scheduled
+	for(int i = 0; i < ntype; i++){
+		if(byType[i].empty())
+			continue;
+		for(long int k = 0; k < state[i]; k++)
+			queue.push(lifetimes[i].sample(), i);
+	}
+
+	if(!silent){
+		std::cout << "Simulation Start Time: " << 0 << std::endl;
+		std::cout << "Simulation End Time: " << totTime << std::endl;
+		std::cout << "obsTimes.size(): " << obsTimes.size() << std::endl;
+	}
+
+	size_t curObsIndex = 0;
+	double curTime = 0;
+	unsigned int parent;
+	STATS(double statsStart = seconds(); stats.replicates++; stats.events.resize(std::max(stats.events.size(), updates.size()), 0);)
+	long int nevents = 0;
+	while(true){
+		if((++nevents & 0xFFFF) == 0)
+			checkInterrupt();
+
+		bool more = queue.pop(curTime, parent);
+
+		// Record every observation time that passes before the next death
+		while(curObsIndex < obsTimes.size() && (!more || curTime > obsTimes[curObsIndex])){
+			toFile(obsTimes[curObsIndex], file);
+			curObsIndex++;
+		}
+		if(!more)
+			break;
+
+		// Pick the transition and schedule the offspring
+		double r = gsl_rng_uniform(gen);
+		size_t c = 0;
+		while(c < cumProbs[parent].size() - 1 && r > cumProbs[parent][c])
+			c++;
+		int index = byType[parent][c];
+		STATS(stats.events[index]++;)
+
+		std::vector<int> update = updates[index].get();
+		for(int j = 0; j < ntype; j++){
+			if(byType[j].empty())
+				continue;
+			for(int k = 0; k < update[j]; k++)
+				queue.push(curTime + lifetimes[j].sample(), j);
+		}
+		update[parent] = update[parent] - 1;
+		updateSystem(update);
+
+		bool stop = false;
+		STATS(stats.stopChecks += stops.size();)
+		for(size_t i = 0; i < stops.size(); i++){
+			if(stops[i].check(state))
+				stop = true;
+		}
+
+		if(stop){
+			STATS(stats.stopped++;)
+			toFile(curTime, file);
+			if(!silent)
+				std::cout << "A stopping criterion has been met. Exiting simulation..." << std::endl;
+			break;
+		}
+
+		bool zero = true;
+		for(int i = 0; i < ntype; i++){
+			if(state[i] > 0)
+				zero = false;
+		}
+
+		if(zero){
+			STATS(stats.extinct++;)
+			toFile(curTime, file);
+			if(!silent)
+				std::cout << "All populations have gone extinct.  Exiting simulation..." << std::endl;
+			break;
+		}
+	}
+	STATS(stats.simulateSeconds += seconds() - statsStart;)
+	if(!silent)
+		std::cout << "End Simulation Time: " << totTime << std::endl;
+}
+
+bool System::advance(double& curTime, double endTime, const StopCriterion& target, double level, std::vector<double>& o_rates){
+	while(target.level(state) < level){
+		bool zero = true;
+		for(size_t i = 0; i < state.size(); i++){
+			if(state[i] > 0)
+				zero = false;
+		}
+		if(zero)
+			return false;
+
+		double timeToNext = getNextTime(o_rates);
+		if(curTime + timeToNext > endTime){
+			curTime = endTime;
+			return false;
+		}
+		curTime += timeToNext;
+
+		int index = choose(o_rates, gen);
+		std::vector<int> update = updates[index].get();
+		update[from[index]] = update[from[index]] - 1;
+		updateSystem(update);
+	}
+	return true;
+}
@@ -16,15 +16,28 @@
  * =====================================================================================
  */
 
+#include "helpers.h"
+
 #include <iostream>
 #include <iomanip>
 #include <math.h>
+#include <stdint.h>
+#include <stdexcept>
+#include <numeric>
+#include <algorithm>
+#include <functional>
 #include <gsl/gsl_randist.h>
 #include <gsl/gsl_math.h>
 
+#ifndef ESTIPOP_STANDALONE
 #include <RcppGSL.h>
 #include <Rcpp.h>
 #include <Rinternals.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 extern gsl_rng* rng;
 
@@ -45,9 +58,14 @@ std::vector<double> normalize(std::vector<double> input)
 // Input: list of 'n' doubles
 // Output: a choice from 1 to n according to probability from input
 int choose(std::vector<double> input)
+{
+    return choose(input, rng);
+}
+
+int choose(std::vector<double> input, gsl_rng* gen)
 {
     std::vector<double> c_norm = normalize(input);
-    double r = gsl_rng_uniform(rng);
+    double r = gsl_rng_uniform(gen);
 
     // Choose which input
     for(size_t i = 0; i < input.size(); i++)
@@ -97,3 +115,147 @@ void maximizePiecewise(gsl_function rate_function, double start_time, double end
   }
 }
 
+// In-place Cholesky factorization of a symmetric n x n matrix stored column-major.
+// On success the lower triangle holds L with A = L L^T; returns false if A is not positive definite.
+bool cholesky(std::vector<double>& a, int n)
+{
+  for(int j = 0; j < n; ++j)
+  {
+    double d = a[j + n*j];
+    for(int k = 0; k < j; ++k)
+      d -= a[j + n*k] * a[j + n*k];
+    if(!(d > 0))
+      return false;
+    d = sqrt(d);
+    a[j + n*j] = d;
+
+    for(int i = j + 1; i < n; ++i)
+    {
+      double s = a[i + n*j];
+      for(int k = 0; k < j; ++k)
+        s -= a[i + n*k] * a[j + n*k];
+      a[i + n*j] = s / d;
+    }
+  }
+  return true;
+}
+
+// Solve L z = x in place by forward substitution and return z^T z
+double forwardSolveNorm(const std::vector<double>& l, int n, std::vector<double>& x)
+{
+  double norm = 0;
+  for(int i = 0; i < n; ++i)
+  {
+    double s = x[i];
+    for(int k = 0; k < i; ++k)
+      s -= l[i + n*k] * x[k];
+    x[i] = s / l[i + n*i];
+    norm += x[i] * x[i];
+  }
+  return norm;
+}
+
+// Solve (L L^T) x = b in place given the Cholesky factor L
+void choleskySolve(const std::vector<double>& l, int n, std::vector<double>& x)
+{
+  forwardSolveNorm(l, n, x);
+  for(int i = n - 1; i >= 0; --i)
+  {
+    double s = x[i];
+    for(int k = i + 1; k < n; ++k)
+      s -= l[k + n*i] * x[k];
+    x[i] = s / l[i + n*i];
+  }
+}
+
+static uint64_t splitmix64(uint64_t& x)
+{
+  uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30))*0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27))*0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+// Start r on draw index of a stream (a generation, an observation step), so that results do not depend on which
+// thread makes the draw. The splitmix64 hash of (seed, stream, index) seeds the generator through the public API;
+// gsl_rng_set keeps as many bits of it as the generator takes (32 for mt19937).
+void seedStream(gsl_rng* r, unsigned long int seed, unsigned long int stream, unsigned long int index)
+{
+  uint64_t x = (uint64_t)seed + 0x9e3779b97f4a7c15ULL*((uint64_t)stream*0x100000000ULL + (uint64_t)index + 1);
+  gsl_rng_set(r, (unsigned long int)splitmix64(x));
+}
+
+std::vector<std::vector<int> > transitionDeltas(std::vector<std::vector<int> > offspring, const std::vector<int>& from)
+{
+  for(size_t k = 0; k < offspring.size(); k++)
+    offspring[k][from[k]] -= 1;
+  return offspring;
+}
+
+std::vector<std::vector<int> > transitionDeltas(std::vector<Update>& updates, const std::vector<int>& from)
+{
+  std::vector<std::vector<int> > offspring;
+  for(size_t k = 0; k < updates.size(); k++)
+    offspring.push_back(updates[k].get());
+  return transitionDeltas(offspring, from);
+}
+
+// Rounding can leave u past the last propensity, so the pick steps back over trailing zeros rather than fire a
+// transition that cannot happen
+int chooseTransition(const std::vector<double>& a, double total, gsl_rng* r)
+{
+  int n = a.size();
+  double u = gsl_rng_uniform(r) * total;
+  int j = 0;
+  while(j < n - 1 && u >= a[j]){
+    u -= a[j];
+    ++j;
+  }
+  while(j > 0 && a[j] == 0)
+    --j;
+  return j;
+}
+
+#ifdef ESTIPOP_STANDALONE
+volatile std::sig_atomic_t interruptRequested = 0;
+
+#ifdef ESTIPOP_FAULT_INJECTION
+std::atomic<long int> interruptCountdown(0);
+#endif
+
+void checkInterrupt()
+{
+#ifdef ESTIPOP_FAULT_INJECTION
+  if(interruptCountdown > 0 && --interruptCountdown == 0)
+    interruptRequested = 1;
+#endif
+  if(interruptRequested)
+    throw std::runtime_error("interrupted");
+}
+#else
+void checkInterrupt()
+{
+  Rcpp::checkUserInterrupt();
+}
+#endif
+
+int threadIndex()
+{
+#ifdef _OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+ThreadRngs::ThreadRngs(int n)
+{
+  for(int i = 0; i < n; ++i)
+    rngs.push_back(gsl_rng_alloc(gsl_rng_mt19937));
+}
+
+ThreadRngs::~ThreadRngs()
+{
+  for(size_t i = 0; i < rngs.size(); ++i)
+    gsl_rng_free(rngs[i]);
+}